@@ -0,0 +1,58 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#define _GNU_SOURCE
+
+#include "bench_port.h"
+
+#include <time.h>
+
+static uint64_t _txBytes;
+static void (*_sink)(const char* str, size_t len);
+
+void cli_port_init(void) {}
+void cli_port_get_uid(uint32_t uid[3]) { uid[0] = uid[1] = uid[2] = 0; }
+void cli_port_reset(void) {}
+void cli_port_delay_ms(uint32_t ms) { (void) ms; }
+int16_t cli_port_read(void) { return -1; }
+
+void cli_port_write(const char* str, size_t len)
+{
+    _txBytes += len;
+    if (_sink != NULL)
+        _sink(str, len);
+}
+
+void bench_port_set_sink(void (*sink)(const char* str, size_t len))
+{
+    _sink = sink;
+}
+
+uint64_t bench_port_tx_bytes(void)
+{
+    return _txBytes;
+}
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
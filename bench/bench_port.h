@@ -0,0 +1,40 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#ifndef _BENCH_PORT_H_
+#define _BENCH_PORT_H_
+
+#include "cli_port.h"
+
+/*
+ * Fake port of benchmarks: TX bytes are counted and dropped, there is no RX and
+ * no tick thread, SysTick_CLI is called only by the benchmark.
+ */
+
+/** @brief Also pass CLI output to sink (terminal model), NULL - only count */
+void bench_port_set_sink(void (*sink)(const char* str, size_t len));
+
+/** @brief Count of bytes written by CLI */
+uint64_t bench_port_tx_bytes(void);
+
+/** @brief CLOCK_MONOTONIC time in ns */
+uint64_t bench_now_ns(void);
+
+#endif // _BENCH_PORT_H_
@@ -0,0 +1,478 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+/*
+ * Microbenchmarks of input, dispatch, parsing and formatting hot paths.
+ *
+ *   cli_bench [<scale>] > result.json
+ *
+ * White-box: includes cli.c for static functions (_find_cli_command, _split).
+ * Platform is the fake port of bench_port.c, SysTick_CLI is called
+ * only by the benchmark (one tick per measured run), so results do not depend on
+ * wall clock time of the CLI. Time is measured with CLOCK_MONOTONIC, best of
+ * BENCH_REPEAT runs.
+ */
+
+#define _GNU_SOURCE
+
+#include "../cli.c"
+#include "bench_port.h"
+#include "cli_rpc.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_REPEAT        (5)                 // runs of one case, best is reported
+#define BENCH_NAME_SIZE     (8)                 // "c0000" + '\0'
+
+static struct{
+    uint32_t scale;                             // iterations multiplier
+    bool first;                                 // first JSON result
+    uint16_t cmdCount;                          // _find_cli_command case
+    uint8_t argCount;                           // _split case
+    uint8_t fmt;                                // format case, index in _formats
+    char names[CLI_SIZE_MAX_CMD][BENCH_NAME_SIZE];
+}Bench_s = {1, true, 0, 0, 0, {{0}}};
+
+static volatile uint32_t _sink;                 // keeps results of benchmarked calls
+
+
+/**
+ * @brief Run case and print JSON result
+ * @param name - case name
+ * @param unit - name of one operation ("byte", "call")
+ * @param fcn - benchmark, executes n calls
+ * @param n - count of calls, multiplied by scale
+ * @param opsPerCall - operations in one call (bytes of input)
+ * */
+static void _run(const char* name, const char* unit, void (*fcn)(uint32_t n), uint32_t n, uint32_t opsPerCall)
+{
+    uint64_t best = UINT64_MAX;
+    uint64_t tx = bench_port_tx_bytes();
+
+    n *= Bench_s.scale;
+    fcn(n / 10 + 1);                            // warm up
+
+    tx = bench_port_tx_bytes();
+    for (uint8_t r = 0; r < BENCH_REPEAT; r++) {
+        SysTick_CLI();
+        uint64_t t0 = bench_now_ns();
+        fcn(n);
+        uint64_t dt = bench_now_ns() - t0;
+        if (dt < best)
+            best = dt;
+    }
+    tx = (bench_port_tx_bytes() - tx) / BENCH_REPEAT;
+
+    double ops = (double) n * opsPerCall;
+    double ns = (double) best / ops;
+
+    fprintf(stdout, "%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, \"ops\": %.0f, \"tx_bytes_per_op\": %.2f}",
+            Bench_s.first ? "" : ",", name, unit, ns, 1e9 / ns, ops, (double) tx / ops);
+    Bench_s.first = false;
+}
+
+
+// ***************************** input *************************************
+
+static const char _plain[] = "repeat 10 100ms stats -m";
+
+static void _append_plain(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        for (const char* p = _plain; *p; p++)
+            cli_append_char(*p);
+        cli_input_reset();
+    }
+}
+
+// cursor Left x4, Right x4
+static const char _escape[] = "\x1b[D\x1b[D\x1b[D\x1b[D\x1b[C\x1b[C\x1b[C\x1b[C";
+
+static void _append_escape(uint32_t n)
+{
+    for (const char* p = "abcdefgh"; *p; p++)
+        cli_append_char(*p);
+
+    for (uint32_t i = 0; i < n; i++) {
+        for (const char* p = _escape; *p; p++)
+            cli_append_char(*p);
+    }
+    cli_input_reset();
+}
+
+
+// ***************************** dispatch **********************************
+
+static CLI_Result_t _nop_cmd(void)
+{
+    return CLI_OK;
+}
+
+static void _set_commands(uint16_t count)
+{
+    CLI_State_s.countCommand = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        snprintf_(Bench_s.names[i], BENCH_NAME_SIZE, "c%04u", (unsigned int) i);
+        cli_add_new_cmd(Bench_s.names[i], _nop_cmd, 0, CLI_PrintNone, "");
+    }
+    Bench_s.cmdCount = count;
+}
+
+static void _find_last(uint32_t n)
+{
+    const char* name = Bench_s.names[Bench_s.cmdCount - 1];
+    for (uint32_t i = 0; i < n; i++)
+        _sink += (_find_cli_command(name) != NULL);
+}
+
+static void _find_miss(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        _sink += (_find_cli_command("cX999") != NULL);
+}
+
+
+// ***************************** parsing ***********************************
+
+static char _splitLine[CLI_CMD_BUF_SIZE + 1];
+static CLI_Params_t _splitArgs;
+
+static void _split_args(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        _split(_splitLine, " ", &_splitArgs);
+        _sink += _splitArgs.argc;
+    }
+}
+
+
+// ***************************** formatting ********************************
+
+typedef enum{
+    ARG_INT = 0,
+    ARG_DOUBLE,
+    ARG_STR
+}BenchArg_t;
+
+static const struct{
+    const char* name;
+    const char* fmt;
+    BenchArg_t arg;
+}_formats[] = {
+    {"literal",  "\r\nstatistics reset",   ARG_INT},
+    {"%d",       "%d",                      ARG_INT},
+    {"%u",       "%u",                      ARG_INT},
+    {"%08X",     "%08X",                    ARG_INT},
+    {"%c",       "%c",                      ARG_INT},
+    {"%q16",     "%q16",                    ARG_INT},
+    {"%.3f",     "%.3f",                    ARG_DOUBLE},
+    {"%s",       "%s",                      ARG_STR},
+    {"%-10s",    "%-10s",                   ARG_STR},
+    {"row",      "\r\n%-10s - %s",          ARG_STR},
+};
+
+static void _format(uint32_t n)
+{
+    char buf[64];
+    const char* f = _formats[Bench_s.fmt].fmt;
+    BenchArg_t arg = _formats[Bench_s.fmt].arg;
+
+    for (uint32_t i = 0; i < n; i++) {
+        int len;
+        if (arg == ARG_INT)
+            len = snprintf_(buf, sizeof(buf), f, (int) (i * 2654435761U) >> 8);
+        else if (arg == ARG_DOUBLE)
+            len = snprintf_(buf, sizeof(buf), f, (double) i * 0.37);
+        else
+            len = snprintf_(buf, sizeof(buf), f, "command", "description of command");
+        _sink += (uint32_t) len;
+    }
+}
+
+/** @brief Output of formats checked once, failures are reported in JSON and exit code */
+static const struct{
+    const char* fmt;
+    BenchArg_t arg;
+    int i;
+    double d;
+    const char* expected;
+}_formatChecks[] = {
+    {"%.3q16",      ARG_INT,    0x18000,    0.0,    "1.500"},
+    {"%.12q16",     ARG_INT,    0x18000,    0.0,    "1.500000000000"},
+    {"%.12f",       ARG_DOUBLE, 0,          1.5,    "1.500000000000"},
+    {"%.12q16",     ARG_INT,    -0x18000,   0.0,    "-1.500000000000"},
+    {"%18.12q16",   ARG_INT,    0x18000,    0.0,    "    1.500000000000"},
+    {"%018.12q16",  ARG_INT,    -0x18000,   0.0,    "-0001.500000000000"},
+    {"%-18.12q16|", ARG_INT,    0x18000,    0.0,    "1.500000000000    |"},
+    {"%.11q8",      ARG_INT,    0x140,      0.0,    "1.25000000000"},
+    {"%.11q3.11",   ARG_INT,    -102618,    0.0,    "-50.10644531250"},
+    {"%.10q16",     ARG_INT,    0x1FFFF,    0.0,    "1.9999847412"},
+    {"%.10q32",     ARG_INT,    1,          0.0,    "0.0000000002"},
+    {"%.12q32",     ARG_INT,    -1,         0.0,    "-0.000000000233"},
+};
+
+static uint32_t _check_formats(void)
+{
+    uint32_t failures = 0;
+    char buf[64];
+
+    for (uint8_t i = 0; i < sizeof(_formatChecks) / sizeof(_formatChecks[0]); i++) {
+        if (_formatChecks[i].arg == ARG_INT)
+            snprintf_(buf, sizeof(buf), _formatChecks[i].fmt, _formatChecks[i].i);
+        else
+            snprintf_(buf, sizeof(buf), _formatChecks[i].fmt, _formatChecks[i].d);
+
+        if (strcmp(buf, _formatChecks[i].expected) != 0) {
+            fprintf(stderr, "format \"%s\": \"%s\", expected \"%s\"\n", _formatChecks[i].fmt, buf, _formatChecks[i].expected);
+            failures++;
+        }
+    }
+
+    return failures;
+}
+
+static uint32_t _countCalls;                    // executions of "count" command of checks
+
+static CLI_Result_t _count_cmd(void)
+{
+    _countCalls++;
+    return CLI_OK;
+}
+
+#if (CLI_SCHED_EN == 1)
+#define REPEAT_CHECK_COUNT  (20)                // executions of "repeat" without period
+
+/** @brief "repeat N <cmd>" without period completes within N passes, fake time does not advance */
+static uint32_t _check_repeat(void)
+{
+    char cmd[CLI_CMD_BUF_SIZE + 1];
+
+    snprintf_(cmd, sizeof(cmd), "repeat %u count", (unsigned int) REPEAT_CHECK_COUNT);
+    if (cli_execute(cmd) != CLI_OK) {
+        fprintf(stderr, "sched \"%s\": not added\n", cmd);
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < REPEAT_CHECK_COUNT; i++)
+        cli_loop_service();
+
+    if ((_countCalls != REPEAT_CHECK_COUNT) || (cli_sched_count() != 0)) {
+        fprintf(stderr, "sched \"%s\": %u executions in %u passes, %u jobs left\n", cmd, (unsigned int) _countCalls,
+                (unsigned int) REPEAT_CHECK_COUNT, (unsigned int) cli_sched_count());
+        return 1;
+    }
+
+    return 0;
+}
+#endif
+
+#if (CLI_SCRIPT_EN == 1)
+#define SLOW_STEPS          (3)                 // steps of resumable command in chain and script
+
+static CLI_Result_t _slow_cmd(void)
+{
+    return (cli_get_job_step() + 1U < SLOW_STEPS) ? CLI_Continue : CLI_OK;
+}
+
+/** @brief Resumable command of chain or script yields to loop, rest runs on next passes */
+static uint32_t _check_script_case(const char* line, uint32_t passes)
+{
+    uint32_t count = _countCalls;
+
+    if ((ExecuteString(line) != CLI_Continue) || (_countCalls != count)) {
+        fprintf(stderr, "script \"%s\": executed in one pass\n", line);
+        return 1;
+    }
+
+    for (uint32_t i = 0; (i < passes) && CLI_State_s.session->fg.active; i++)
+        cli_loop_service();
+
+    if (CLI_State_s.session->fg.active || (_countCalls != count + 1)) {
+        fprintf(stderr, "script \"%s\": not finished in %u passes\n", line, (unsigned int) passes);
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint32_t _check_script(void)
+{
+    cli_add_new_cmd("slow", _slow_cmd, 0, CLI_PrintNone, "");
+    cli_script_add("slow2", "slow\n# comment\ncount\n");
+
+    return _check_script_case("slow; count", SLOW_STEPS) +
+           _check_script_case("run slow2", SLOW_STEPS + 2);
+}
+#endif
+
+static void _cli_printf(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        CLI_PRINTF("\r\n%-10s - %s", "command", "description of command");
+}
+
+
+// ***************************** requests **********************************
+
+#if (CLI_RPC_EN == 1)
+static const char _textReq[] = "mr 20000000\r";
+static uint8_t _rpcReq[CLI_RPC_FRAME_SIZE];
+static size_t _rpcReqLen;
+
+static void _feed(const char* data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (cli_append_char(data[i]) == CLI_APPEND_Enter)
+            cli_loop_service();
+    }
+}
+
+static void _request_text(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        _feed(_textReq, sizeof(_textReq) - 1);
+}
+
+static void _request_rpc(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        _feed((const char*) _rpcReq, _rpcReqLen);
+}
+
+/** @brief Encoded request with 0x00 delimiter */
+static size_t _rpc_frame(uint8_t* dst, uint16_t id, const uint8_t* args, uint8_t len)
+{
+    uint8_t raw[16] = {1, (uint8_t) id, (uint8_t) (id >> 8)};
+
+    if (len != 0)
+        memcpy(&raw[3], args, len);
+    len += 3;
+
+    uint16_t crc = cli_rpc_crc16(raw, len);
+    raw[len++] = (uint8_t) crc;
+    raw[len++] = (uint8_t) (crc >> 8);
+
+    size_t n = cli_rpc_cobs_encode(raw, len, dst);
+    dst[n++] = 0;
+    return n;
+}
+
+/** @brief "mr 20000000" in text and RPC mode */
+static void _bench_requests(void)
+{
+    static const uint8_t addr[] = {CLI_RPC_ARG_HEX, 0x00, 0x00, 0x00, 0x20};
+    uint16_t id = 0;
+
+    while (!_strcmp(cli_get_cmd_name(id), "mr"))
+        id++;
+
+    _run("request.text", "request", _request_text, 20000, 1);
+
+    _feed(CLI_RPC_ENTER_SEQ, sizeof(CLI_RPC_ENTER_SEQ) - 1);
+    _rpcReqLen = _rpc_frame(_rpcReq, id, addr, sizeof(addr));
+    _run("request.rpc", "request", _request_rpc, 20000, 1);
+
+    _rpcReqLen = _rpc_frame(_rpcReq, CLI_RPC_ID_EXIT, NULL, 0);
+    _feed((const char*) _rpcReq, _rpcReqLen);
+}
+#endif
+
+
+// ***************************** history ***********************************
+
+static void _history_push(uint32_t n)
+{
+    char cmd[2][CLI_CMD_BUF_SIZE] = {"stats -m", "md 20000000 64"};
+
+    for (uint32_t i = 0; i < n; i++)
+        cli_log_cmd_push(cmd[i & 1]);
+}
+
+
+int main(int argc, char** argv)
+{
+    char name[48];
+
+    if (argc > 1)
+        Bench_s.scale = (uint32_t) strtoul(argv[1], NULL, 10);
+    if (Bench_s.scale == 0)
+        Bench_s.scale = 1;
+
+    cli_init();
+    cli_set_first_in_cli(true);
+
+    // before _set_commands replaces built-in commands
+    uint32_t schedFailures = 0, scriptFailures = 0;
+    cli_add_new_cmd("count", _count_cmd, 0, CLI_PrintNone, "");
+#if (CLI_SCHED_EN == 1)
+    schedFailures = _check_repeat();
+#endif
+#if (CLI_SCRIPT_EN == 1)
+    scriptFailures = _check_script();
+#endif
+
+    fprintf(stdout, "{\n  \"benchmark\": \"cli\",\n  \"tick\": \"fake\",\n  \"scale\": %u,\n", (unsigned int) Bench_s.scale);
+    fprintf(stdout, "  \"config\": {\"CLI_CMD_BUF_SIZE\": %d, \"CLI_ARGS_BUF_SIZE\": %d, \"CLI_CMD_LOG_SIZE\": %d, \"CLI_SIZE_MAX_CMD\": %d},\n",
+            CLI_CMD_BUF_SIZE, CLI_ARGS_BUF_SIZE, CLI_CMD_LOG_SIZE, CLI_SIZE_MAX_CMD);
+    fprintf(stdout, "  \"results\": [");
+
+    _run("append_char.plain", "byte", _append_plain, 20000, sizeof(_plain) - 1);
+    _run("append_char.escape", "byte", _append_escape, 20000, sizeof(_escape) - 1);
+#if (CLI_RPC_EN == 1)
+    _bench_requests();
+#endif
+
+    static const uint16_t counts[] = {10, 100, 1000};
+    for (uint8_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        if (counts[i] > CLI_SIZE_MAX_CMD)
+            break;
+        _set_commands(counts[i]);
+        snprintf_(name, sizeof(name), "find_command.last.%u", (unsigned int) counts[i]);
+        _run(name, "call", _find_last, 2000000 / counts[i], 1);
+        snprintf_(name, sizeof(name), "find_command.miss.%u", (unsigned int) counts[i]);
+        _run(name, "call", _find_miss, 2000000 / counts[i], 1);
+    }
+
+    _splitArgs.argv = CLI_State_s.session->argv;
+    for (uint8_t args = 0; args < CLI_ARGS_BUF_SIZE; args = (args == 0) ? 1 : args * 2) {
+        uint8_t len = (uint8_t) snprintf_(_splitLine, sizeof(_splitLine), "cmd");
+        for (uint8_t a = 0; (a < args) && (len + 3 <= CLI_CMD_BUF_SIZE); a++)
+            len += (uint8_t) snprintf_(_splitLine + len, sizeof(_splitLine) - len, " a%u", (unsigned int) a % 10);
+        snprintf_(name, sizeof(name), "split.args.%u", (unsigned int) args);
+        _run(name, "call", _split_args, 200000, 1);
+    }
+
+    for (uint8_t i = 0; i < sizeof(_formats) / sizeof(_formats[0]); i++) {
+        Bench_s.fmt = i;
+        snprintf_(name, sizeof(name), "printf.%s", _formats[i].name);
+        _run(name, "call", _format, 200000, 1);
+    }
+    _run("CLI_PRINTF.row", "call", _cli_printf, 200000, 1);
+
+    _run("history.push", "call", _history_push, 200000, 1);
+
+    uint32_t failures = _check_formats();
+    fprintf(stdout, "\n  ],\n  \"format_failures\": %u,\n  \"sched_failures\": %u,\n  \"script_failures\": %u\n}\n",
+            (unsigned int) failures, (unsigned int) schedFailures, (unsigned int) scriptFailures);
+    return ((failures == 0) && (schedFailures == 0) && (scriptFailures == 0)) ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+/*
+ * Replay of input recorded by "cli_host --record <file>".
+ *
+ *   cli_replay [--realtime] <file> > result.json
+ *
+ * Chars are fed to cli_append_char, the line is executed by cli_loop_service
+ * after Enter. Recorded tick deltas drive SysTick_CLI of the fake port (bench_port.c),
+ * so scheduled jobs and timeouts see the same time as in the recorded session.
+ * By default ticks are advanced without waiting (max speed), --realtime sleeps
+ * one tick period per tick (original timing).
+ *
+ * Reported: bytes per second of input processing, output bytes and percentiles
+ * of per-line latency (time spent in cli_append_char for chars of the line and
+ * in cli_loop_service executing it). Time of idle ticks is not included.
+ */
+
+#define _GNU_SOURCE
+
+#include "cli.h"
+#include "cli_rec.h"
+#include "bench_port.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static struct{
+    bool realtime;                              // sleep between ticks
+    struct timespec next;                       // deadline of next tick (realtime)
+    uint64_t ticks;                             // local ticks advanced
+    uint64_t inputBytes;
+    uint64_t processNs;                         // time in cli_append_char and line execute
+    uint64_t* lines;                            // latency of lines in ns
+    uint32_t lineCount;
+    uint32_t lineCap;
+}Replay_s;
+
+
+static uint8_t* _load(const char* name, size_t* size)
+{
+    FILE* f = fopen(name, "rb");
+    uint8_t* data = NULL;
+    long len;
+
+    if (f == NULL)
+        return NULL;
+
+    if ((fseek(f, 0, SEEK_END) == 0) && ((len = ftell(f)) > 0) && (fseek(f, 0, SEEK_SET) == 0)) {
+        data = malloc((size_t) len);
+        if ((data != NULL) && (fread(data, 1, (size_t) len, f) != (size_t) len)) {
+            free(data);
+            data = NULL;
+        }
+        *size = (size_t) len;
+    }
+
+    fclose(f);
+    return data;
+}
+
+static void _advance_tick(void)
+{
+    if (Replay_s.realtime) {
+        Replay_s.next.tv_nsec += 1000000000L / CLI_TICK_FREQ_HZ;
+        if (Replay_s.next.tv_nsec >= 1000000000L) {
+            Replay_s.next.tv_nsec -= 1000000000L;
+            Replay_s.next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Replay_s.next, NULL);
+    }
+
+    SysTick_CLI();
+    Replay_s.ticks++;
+    cli_loop_service();
+}
+
+static void _push_line(uint64_t ns)
+{
+    if (Replay_s.lineCount == Replay_s.lineCap) {
+        uint32_t cap = (Replay_s.lineCap != 0) ? Replay_s.lineCap * 2 : 256;
+        uint64_t* lines = realloc(Replay_s.lines, cap * sizeof(uint64_t));
+
+        if (lines == NULL)
+            return;
+        Replay_s.lines = lines;
+        Replay_s.lineCap = cap;
+    }
+
+    Replay_s.lines[Replay_s.lineCount++] = ns;
+}
+
+static int _cmp_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+
+    return (x > y) - (x < y);
+}
+
+/** @brief Percentile of sorted line latencies in us, nearest rank */
+static double _percentile_us(uint32_t p)
+{
+    if (Replay_s.lineCount == 0)
+        return 0;
+
+    uint32_t rank = (uint32_t) (((uint64_t) p * Replay_s.lineCount + 99) / 100);
+    if (rank == 0)
+        rank = 1;
+
+    return (double) Replay_s.lines[rank - 1] / 1000.0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* name = NULL;
+    CLI_RecReader_t rd;
+    uint8_t* data;
+    size_t size = 0;
+    uint64_t recTicks = 0;
+    uint64_t lineNs = 0;
+    uint32_t dt;
+    char ch;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--realtime") == 0)
+            Replay_s.realtime = true;
+        else
+            name = argv[i];
+    }
+
+    if (name == NULL) {
+        fprintf(stderr, "usage: %s [--realtime] <file>\n", argv[0]);
+        return 1;
+    }
+
+    data = _load(name, &size);
+    if ((data == NULL) || !cli_rec_reader_init(&rd, data, size)) {
+        fprintf(stderr, "%s: not a CLI record\n", name);
+        free(data);
+        return 1;
+    }
+
+    cli_init();
+
+    uint64_t txStart = bench_port_tx_bytes();
+    uint64_t wallStart = bench_now_ns();
+    clock_gettime(CLOCK_MONOTONIC, &Replay_s.next);
+
+    for (;;) {
+        bool more = cli_rec_next(&rd, &dt, &ch);
+
+        // ticks of recorder to local ticks
+        recTicks += dt;
+        uint64_t target = recTicks * CLI_TICK_FREQ_HZ / rd.freqHz;
+        while (Replay_s.ticks < target)
+            _advance_tick();
+
+        if (!more)
+            break;
+
+        uint64_t t0 = bench_now_ns();
+        bool enter = (cli_append_char(ch) == CLI_APPEND_Enter);
+        if (enter)
+            cli_loop_service();
+        uint64_t t = bench_now_ns() - t0;
+
+        Replay_s.inputBytes++;
+        Replay_s.processNs += t;
+        lineNs += t;
+        if (enter) {
+            _push_line(lineNs);
+            lineNs = 0;
+        }
+    }
+
+    uint64_t wallNs = bench_now_ns() - wallStart;
+    qsort(Replay_s.lines, Replay_s.lineCount, sizeof(uint64_t), _cmp_u64);
+
+    fprintf(stdout, "{\n");
+    fprintf(stdout, "  \"replay\": \"%s\",\n", name);
+    fprintf(stdout, "  \"mode\": \"%s\",\n", Replay_s.realtime ? "realtime" : "max_speed");
+    fprintf(stdout, "  \"record_bytes\": %zu,\n", size);
+    fprintf(stdout, "  \"input_bytes\": %llu,\n", (unsigned long long) Replay_s.inputBytes);
+    fprintf(stdout, "  \"lines\": %u,\n", (unsigned int) Replay_s.lineCount);
+    fprintf(stdout, "  \"ticks\": %llu,\n", (unsigned long long) Replay_s.ticks);
+    fprintf(stdout, "  \"wall_ms\": %.3f,\n", (double) wallNs / 1e6);
+    fprintf(stdout, "  \"process_ms\": %.3f,\n", (double) Replay_s.processNs / 1e6);
+    fprintf(stdout, "  \"bytes_per_sec\": %.0f,\n",
+            (Replay_s.processNs != 0) ? (double) Replay_s.inputBytes * 1e9 / (double) Replay_s.processNs : 0.0);
+    fprintf(stdout, "  \"tx_bytes\": %llu,\n", (unsigned long long) (bench_port_tx_bytes() - txStart));
+    fprintf(stdout, "  \"line_latency_us\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}\n",
+            _percentile_us(50), _percentile_us(90), _percentile_us(99), _percentile_us(100));
+    fprintf(stdout, "}\n");
+
+    free(Replay_s.lines);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,258 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+/*
+ * Redraw oracle of line editor: CLI output is applied to VT100 screen model
+ * (vt100.c), after every keystroke the prompt row must show the input buffer
+ * and the terminal cursor must be at the buffer cursor.
+ *
+ *   cli_vt100 [<keys>] > result.json
+ *
+ * Scripted cases check final screen of one edit, random edits (fixed seed) check
+ * the invariant. Reported: bytes put on the wire per keystroke type.
+ * Exit code 1 if screen and buffer diverge.
+ */
+
+#include "cli.h"
+#include "cli_input.h"
+#include "cli_log.h"
+#include "bench_port.h"
+#include "vt100.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROMPT_LEN          (sizeof(STRING_TERM_ARROW) - 1)
+#define RANDOM_KEYS         (20000)             // default count of random keystrokes
+
+/** @brief Keystroke types */
+typedef enum{
+    KEY_CHAR = 0,
+    KEY_BACKSPACE,
+    KEY_DELETE,
+    KEY_LEFT,
+    KEY_RIGHT,
+    KEY_HOME,
+    KEY_END,
+    KEY_UP,
+    KEY_DOWN,
+    KEY_TAB,
+    KEY_COUNT
+}Key_t;
+
+static const struct{
+    const char* name;
+    const char* seq;                            // NULL - printable char
+}_keys[KEY_COUNT] = {
+    {"char",        NULL},
+    {"backspace",   "\b"},
+    {"delete",      "\x1b[3~"},
+    {"left",        "\x1b[D"},
+    {"right",       "\x1b[C"},
+    {"home",        "\x1b[1~"},
+    {"end",         "\x1b[4~"},
+    {"up",          "\x1b[A"},
+    {"down",        "\x1b[B"},
+    {"tab",         "\t"},
+};
+
+/*
+ * Scripted edits: setup keys, measured key, expected line ('|' - cursor).
+ * In setup "<" is Left, history: "md 0x20000000" (last), "repeat 10 100ms stats".
+ */
+static const struct{
+    const char* name;
+    const char* setup;
+    Key_t key;
+    const char* ch;                             // char of KEY_CHAR
+    const char* expect;
+}_cases[] = {
+    {"char.end",            "stats -m",     KEY_CHAR,       "x",    "stats -mx|"},
+    {"char.insert",         "stats -m<<<",  KEY_CHAR,       "x",    "statsx| -m"},
+    {"backspace.end",       "stats -m",     KEY_BACKSPACE,  NULL,   "stats -|"},
+    {"backspace.mid",       "stats -m<<<",  KEY_BACKSPACE,  NULL,   "stat| -m"},
+    {"delete.mid",          "stats -m<<<",  KEY_DELETE,     NULL,   "stats|-m"},
+    {"left",                "stats -m",     KEY_LEFT,       NULL,   "stats -|m"},
+    {"right",               "stats -m<<<",  KEY_RIGHT,      NULL,   "stats |-m"},
+    {"home",                "stats -m",     KEY_HOME,       NULL,   "|stats -m"},
+    {"end",                 "stats -m<<<",  KEY_END,        NULL,   "stats -m|"},
+    {"up.longer",           "st",           KEY_UP,         NULL,   "md 0x20000000|"},
+    {"up.shorter",          "repeat 10 100ms stats -m", KEY_UP, NULL, "md 0x20000000|"},
+    {"tab",                 "sta",          KEY_TAB,        NULL,   "stats |"},
+};
+
+static struct{
+    uint32_t count[KEY_COUNT];
+    uint64_t bytes[KEY_COUNT];
+    uint32_t maxBytes[KEY_COUNT];
+    uint32_t failures;
+    uint32_t rnd;
+}Oracle_s = {{0}, {0}, {0}, 0, 12345};
+
+
+static uint32_t _rand(void)
+{
+    Oracle_s.rnd = Oracle_s.rnd * 1103515245U + 12345U;
+    return Oracle_s.rnd >> 16;
+}
+
+static void _start_line(void)
+{
+    cli_input_reset();
+    cli_log_cur_reset();
+    vt100_reset();
+    vt100_write(STRING_TERM_ARROW, PROMPT_LEN);
+}
+
+/** @brief Type chars, return bytes of output */
+static uint32_t _type(const char* str, size_t len)
+{
+    uint64_t tx = bench_port_tx_bytes();
+
+    for (size_t i = 0; i < len; i++)
+        cli_append_char(str[i]);
+
+    return (uint32_t) (bench_port_tx_bytes() - tx);
+}
+
+static uint32_t _press(Key_t key, char ch)
+{
+    if (_keys[key].seq == NULL)
+        return _type(&ch, 1);
+
+    return _type(_keys[key].seq, strlen(_keys[key].seq));
+}
+
+/**
+ * @brief Compare prompt row with expected line
+ * @param line - text after prompt
+ * @param cursor - cursor position in line
+ * */
+static bool _check(const char* what, const char* line, uint16_t cursor)
+{
+    char expect[VT100_COLS + 1];
+    uint16_t row = vt100_cursor_row();
+    const char* screen = vt100_row(row);
+
+    snprintf(expect, sizeof(expect), "%s%s", STRING_TERM_ARROW, line);
+    for (size_t len = strlen(expect); (len > 0) && (expect[len - 1] == ' '); len--)
+        expect[len - 1] = '\0';
+
+    if ((strcmp(screen, expect) == 0) && (vt100_cursor_col() == PROMPT_LEN + cursor) && (vt100_unknown() == 0))
+        return true;
+
+    fprintf(stderr, "%s: screen \"%s\" col %u, expected \"%s\" col %u, unknown output %u\n", what, screen,
+            (unsigned int) vt100_cursor_col(), expect, (unsigned int) (PROMPT_LEN + cursor), (unsigned int) vt100_unknown());
+    Oracle_s.failures++;
+    return false;
+}
+
+/** @brief Screen must show input buffer */
+static bool _check_buffer(const char* what)
+{
+    return _check(what, cli_input_get_buffer(MainBuffer), cli_input_get_cursor());
+}
+
+static void _account(Key_t key, uint32_t bytes)
+{
+    Oracle_s.count[key]++;
+    Oracle_s.bytes[key] += bytes;
+    if (bytes > Oracle_s.maxBytes[key])
+        Oracle_s.maxBytes[key] = bytes;
+}
+
+static void _run_cases(void)
+{
+    for (size_t i = 0; i < sizeof(_cases) / sizeof(_cases[0]); i++) {
+        char expect[VT100_COLS];
+        const char* bar = strchr(_cases[i].expect, '|');
+        uint16_t cursor = (uint16_t) (bar - _cases[i].expect);
+
+        snprintf(expect, sizeof(expect), "%.*s%s", (int) cursor, _cases[i].expect, bar + 1);
+
+        _start_line();
+        for (const char* p = _cases[i].setup; *p; p++) {
+            if (*p == '<')
+                _press(KEY_LEFT, 0);
+            else
+                _press(KEY_CHAR, *p);
+        }
+
+        uint32_t bytes = _press(_cases[i].key, (_cases[i].ch != NULL) ? _cases[i].ch[0] : 0);
+        bool ok = _check(_cases[i].name, expect, cursor) && _check_buffer(_cases[i].name);
+
+        fprintf(stdout, "%s\n    {\"name\": \"%s\", \"bytes\": %u, \"ok\": %s}", (i == 0) ? "" : ",",
+                _cases[i].name, (unsigned int) bytes, ok ? "true" : "false");
+    }
+}
+
+static void _run_random(uint32_t count)
+{
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789 -";
+
+    _start_line();
+    for (uint32_t i = 0; i < count; i++) {
+        Key_t key = (Key_t) (_rand() % (KEY_COUNT + 3));
+        char what[32];
+
+        // printable chars are typed more often than editing keys
+        if (key >= KEY_COUNT)
+            key = KEY_CHAR;
+
+        _account(key, _press(key, chars[_rand() % (sizeof(chars) - 1)]));
+
+        snprintf(what, sizeof(what), "random %u %s", (unsigned int) i, _keys[key].name);
+        if (!_check_buffer(what))
+            _start_line();
+
+        // new line from time to time, screen model keeps one line
+        if ((_rand() % 64) == 0)
+            _start_line();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : RANDOM_KEYS;
+
+    bench_port_set_sink(vt100_write);
+    cli_init();
+    cli_set_first_in_cli(true);
+
+    // cli_log copies CLI_CMD_BUF_SIZE chars, as from input buffer
+    static char history[2][CLI_CMD_BUF_SIZE + 1] = {"repeat 10 100ms stats", "md 0x20000000"};
+    cli_log_cmd_push(history[0]);
+    cli_log_cmd_push(history[1]);
+
+    fprintf(stdout, "{\n  \"benchmark\": \"vt100\",\n  \"cases\": [");
+    _run_cases();
+    fprintf(stdout, "\n  ],\n  \"random_keys\": %u,\n  \"keys\": [", (unsigned int) count);
+
+    _run_random(count);
+    for (uint8_t k = 0; k < KEY_COUNT; k++) {
+        double avg = (Oracle_s.count[k] != 0) ? (double) Oracle_s.bytes[k] / Oracle_s.count[k] : 0.0;
+        fprintf(stdout, "%s\n    {\"key\": \"%s\", \"count\": %u, \"bytes_avg\": %.2f, \"bytes_max\": %u}", (k == 0) ? "" : ",",
+                _keys[k].name, (unsigned int) Oracle_s.count[k], avg, (unsigned int) Oracle_s.maxBytes[k]);
+    }
+    fprintf(stdout, "\n  ],\n  \"failures\": %u\n}\n", (unsigned int) Oracle_s.failures);
+
+    return (Oracle_s.failures == 0) ? 0 : 1;
+}
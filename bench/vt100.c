@@ -0,0 +1,246 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#include "vt100.h"
+
+#include <string.h>
+
+#define VT100_MAX_PARAMS    (4)
+
+typedef enum{
+    StateText = 0,
+    StateEsc,
+    StateCsi
+}VT100_State_t;
+
+static struct{
+    char screen[VT100_ROWS][VT100_COLS];
+    uint16_t row;
+    uint16_t col;
+    bool wrapPending;                           // cursor after last column, next char wraps
+    VT100_State_t state;
+    uint16_t params[VT100_MAX_PARAMS];
+    uint8_t paramCount;
+    uint32_t unknown;
+    char rowStr[VT100_COLS + 1];
+}VT100_s;
+
+
+static void _scroll(void)
+{
+    memmove(VT100_s.screen[0], VT100_s.screen[1], (VT100_ROWS - 1) * VT100_COLS);
+    memset(VT100_s.screen[VT100_ROWS - 1], ' ', VT100_COLS);
+}
+
+static void _line_feed(void)
+{
+    if (VT100_s.row + 1 < VT100_ROWS)
+        VT100_s.row++;
+    else
+        _scroll();
+}
+
+static void _put(char c)
+{
+    if (VT100_s.wrapPending) {
+        VT100_s.wrapPending = false;
+        VT100_s.col = 0;
+        _line_feed();
+    }
+
+    VT100_s.screen[VT100_s.row][VT100_s.col] = c;
+    if (VT100_s.col + 1 < VT100_COLS)
+        VT100_s.col++;
+    else
+        VT100_s.wrapPending = true;
+}
+
+static uint16_t _param(uint8_t i, uint16_t def)
+{
+    return ((i < VT100_s.paramCount) && (VT100_s.params[i] != 0)) ? VT100_s.params[i] : def;
+}
+
+static uint16_t _clamp(int32_t v, uint16_t max)
+{
+    return (v < 0) ? 0 : ((v >= max) ? (uint16_t) (max - 1) : (uint16_t) v);
+}
+
+static void _erase(uint16_t row, uint16_t from, uint16_t to)
+{
+    memset(&VT100_s.screen[row][from], ' ', to - from);
+}
+
+static void _csi(char final)
+{
+    uint16_t n = _param(0, 1);
+
+    VT100_s.wrapPending = false;
+
+    switch (final) {
+        case 'A': VT100_s.row = _clamp((int32_t) VT100_s.row - n, VT100_ROWS); break;
+        case 'B': VT100_s.row = _clamp((int32_t) VT100_s.row + n, VT100_ROWS); break;
+        case 'C': VT100_s.col = _clamp((int32_t) VT100_s.col + n, VT100_COLS); break;
+        case 'D': VT100_s.col = _clamp((int32_t) VT100_s.col - n, VT100_COLS); break;
+
+        case 'H':
+        case 'f':
+            VT100_s.row = _clamp((int32_t) _param(0, 1) - 1, VT100_ROWS);
+            VT100_s.col = _clamp((int32_t) _param(1, 1) - 1, VT100_COLS);
+            break;
+
+        case 'J': {
+            uint16_t mode = _param(0, 0);
+            if (mode == 2) {
+                memset(VT100_s.screen, ' ', sizeof(VT100_s.screen));
+            } else if (mode == 0) {
+                _erase(VT100_s.row, VT100_s.col, VT100_COLS);
+                for (uint16_t r = VT100_s.row + 1; r < VT100_ROWS; r++)
+                    _erase(r, 0, VT100_COLS);
+            } else {
+                for (uint16_t r = 0; r < VT100_s.row; r++)
+                    _erase(r, 0, VT100_COLS);
+                _erase(VT100_s.row, 0, VT100_s.col + 1);
+            }
+        }
+            break;
+
+        case 'K': {
+            uint16_t mode = _param(0, 0);
+            if (mode == 0)
+                _erase(VT100_s.row, VT100_s.col, VT100_COLS);
+            else if (mode == 1)
+                _erase(VT100_s.row, 0, VT100_s.col + 1);
+            else
+                _erase(VT100_s.row, 0, VT100_COLS);
+        }
+            break;
+
+        case 'm':
+            break;
+
+        default:
+            VT100_s.unknown++;
+            break;
+    }
+}
+
+void vt100_reset(void)
+{
+    memset(&VT100_s, 0, sizeof(VT100_s));
+    memset(VT100_s.screen, ' ', sizeof(VT100_s.screen));
+}
+
+void vt100_write(const char* str, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        char c = str[i];
+
+        switch (VT100_s.state) {
+            case StateEsc:
+                if (c == '[') {
+                    VT100_s.state = StateCsi;
+                    VT100_s.paramCount = 0;
+                    memset(VT100_s.params, 0, sizeof(VT100_s.params));
+                } else {
+                    VT100_s.state = StateText;
+                    VT100_s.unknown++;
+                }
+                continue;
+
+            case StateCsi:
+                if ((c >= '0') && (c <= '9')) {
+                    if (VT100_s.paramCount == 0)
+                        VT100_s.paramCount = 1;
+                    if (VT100_s.paramCount <= VT100_MAX_PARAMS)
+                        VT100_s.params[VT100_s.paramCount - 1] = VT100_s.params[VT100_s.paramCount - 1] * 10 + (c - '0');
+                } else if (c == ';') {
+                    if (VT100_s.paramCount == 0)
+                        VT100_s.paramCount = 1;
+                    VT100_s.paramCount++;
+                } else {
+                    VT100_s.state = StateText;
+                    _csi(c);
+                }
+                continue;
+
+            default:
+                break;
+        }
+
+        switch (c) {
+            case '\x1b':
+                VT100_s.state = StateEsc;
+                break;
+
+            case '\r':
+                VT100_s.col = 0;
+                VT100_s.wrapPending = false;
+                break;
+
+            case '\n':
+                _line_feed();
+                break;
+
+            case '\b':
+                VT100_s.wrapPending = false;
+                if (VT100_s.col > 0)
+                    VT100_s.col--;
+                break;
+
+            case '\t':
+                VT100_s.col = _clamp((VT100_s.col | 7) + 1, VT100_COLS);
+                break;
+
+            default:
+                if ((uint8_t) c >= 0x20 && (uint8_t) c < 0x7F)
+                    _put(c);
+                else
+                    VT100_s.unknown++;
+                break;
+        }
+    }
+}
+
+const char* vt100_row(uint16_t row)
+{
+    uint16_t len = VT100_COLS;
+
+    memcpy(VT100_s.rowStr, VT100_s.screen[row], VT100_COLS);
+    while ((len > 0) && (VT100_s.rowStr[len - 1] == ' '))
+        len--;
+    VT100_s.rowStr[len] = '\0';
+
+    return VT100_s.rowStr;
+}
+
+uint16_t vt100_cursor_row(void)
+{
+    return VT100_s.row;
+}
+
+uint16_t vt100_cursor_col(void)
+{
+    return VT100_s.col;
+}
+
+uint32_t vt100_unknown(void)
+{
+    return VT100_s.unknown;
+}
@@ -0,0 +1,53 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#ifndef _VT100_H_
+#define _VT100_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Screen model of VT100 terminal for checking CLI output: printable chars with
+ * autowrap, CR, LF, BS, TAB, and CSI sequences of cursor moves (A, B, C, D, H, f),
+ * erase (J, K) and attributes (m, ignored). Unknown sequences are counted.
+ */
+
+#define VT100_ROWS          (24)
+#define VT100_COLS          (80)
+
+/** @brief Clear screen, cursor to home */
+void vt100_reset(void);
+
+/** @brief Apply terminal output */
+void vt100_write(const char* str, size_t len);
+
+/** @brief Text of row without trailing spaces, valid until next call */
+const char* vt100_row(uint16_t row);
+
+/** @brief Cursor position, 0 based */
+uint16_t vt100_cursor_row(void);
+uint16_t vt100_cursor_col(void);
+
+/** @brief Count of chars and sequences not supported by model */
+uint32_t vt100_unknown(void);
+
+#endif // _VT100_H_
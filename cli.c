@@ -37,6 +37,16 @@
 #include "cli_time.h"
 #include "cli_log.h"
 #include "cli_input.h"
+#include "cli_log_rl.h"
+#include "cli_stats.h"
+#include "cli_sched.h"
+#include "cli_script.h"
+#include "cli_vm.h"
+#include "cli_mem.h"
+#include "cli_rec.h"
+#include "cli_rpc.h"
+#include "cli_machine.h"
+#include "cli_port.h"
 
 
 #define PRINT_ARROW()                   {CLI_PRINTF("%s%s",STRING_TERM_ENTER, STRING_TERM_ARROW);}	// Output of input line
@@ -45,17 +55,23 @@
 
 // todo: need refactor this variable, maybe put to struct
 char output_print_buffer[256];
-volatile uint64_t _tick;
-// need change address for another MCU, see datasheet for MCU (for stm32f4 0x1FFF7A10, stm32F1 0x1FFFF7E8) or another MCU
-static volatile uint32_t *UniqueID = (uint32_t *) 0x1FFF7A10;
 
 /** @brief Command settings */
 typedef struct {
-    uint8_t (*fcn)();                   // callback function command
+    CLI_Result_t (*fcn)();              // callback function command
     const char *name;                   // name command
     uint8_t argc;                       // min count argument
     uint16_t mode;                      // mode execute command
     const char *description;            // description command
+#if (CLI_WATCHDOG_EN == 1)
+    uint32_t deadlineMs;                // max execute time, 0 - no deadline
+#endif
+#if (CLI_CMD_STATS_EN == 1)
+    CLI_CmdStats_t stats;               // execute statistics
+#endif
+#if (CLI_STACK_PAINT_EN == 1)
+    uint16_t stackMax;                  // stack high-water of execute in bytes
+#endif
 } CLI_Cmd_t;
 
 typedef struct{
@@ -63,21 +79,95 @@ typedef struct{
     char** argv;
 } CLI_Params_t;
 
-/** @brief CLI State */
-struct {
-    CLI_Cmd_t cmds[CLI_SIZE_MAX_CMD];   // list commands
-    uint8_t countCommand;               // count commands
-    uint8_t executeState;               // state terminal
+/** @brief Foreground resumable command (returned CLI_Continue) */
+typedef struct{
+    char cmd[CLI_CMD_BUF_SIZE + 1];     // command string include arguments
+    uint8_t state[CLI_JOB_STATE_SIZE] __attribute__((aligned(8)));  // state of command
+    uint16_t step;                      // next step
+    bool active;
+    bool request;                       // started by request of machine mode, finished by reply
+#if (CLI_SCRIPT_EN == 1)
+    bool isScript;                      // chain or script of "run" in script cursor
+    CLI_ScriptCursor_t script;          // chain or script executed across loop passes
+#endif
+} CLI_FgJob_t;
+
+/** @brief Session: console of one transport */
+struct CLI_Session {
+    const CLI_Transport_t *transport;   // block read and write
+    void *ctx;                          // context of transport
+    void (*write)(const char *data, size_t len);    // redirect of output (RPC, machine mode), NULL - transport
+    CLI_Input_t input;                  // line editor
+    CLI_Log_t history;                  // history of commands
     volatile CLI_Params_t inputArgs;    // args current execute command
+    char *argv[CLI_ARGS_BUF_SIZE];
+    char argName[CLI_CMD_BUF_SIZE + 1];             // storage of argv[0]
+    char argData[CLI_ARGS_BUF_SIZE - 1][CLI_ARG_SIZE + 1];  // storage of argv[1..]
+    CLI_FgJob_t fg;                     // foreground resumable command
+    volatile bool interrupt;            // Ctrl+C or deadline, abort current command
     bool isEntered;
     bool first_in;
-} CLI_State_s;
+    bool open;
+};
+
+static void _console_write(void *ctx, const char *data, size_t len)
+{
+    (void) ctx;
+    cli_port_write(data, len);
+}
+
+/** @brief Console: output to cli_port, input by cli_append_char (cli_port_read or RX interrupt) */
+static const CLI_Transport_t _consoleTransport = {_console_write, NULL};
+
+static CLI_Session_t _sessions[CLI_SESSION_MAX] = {{.transport = &_consoleTransport}};  // 0 - console of cli_port
+#define CONSOLE                         (&_sessions[0])
+
+/** @brief CLI State */
+struct {
+    CLI_Cmd_t cmds[CLI_SIZE_MAX_CMD];   // list commands
+    uint16_t countCommand;              // count commands
+    uint8_t executeState;               // depth of nested execute commands
+    const char *line;                   // command string of current execute command
+    void *jobState;                     // state buffer of current execute command
+    uint16_t jobStep;                   // step of current execute command
+    CLI_Session_t *session;             // session of current input or execute command
+} CLI_State_s = {.session = CONSOLE};   // output before cli_init goes to console
+
+static uint8_t _scratch_state[CLI_JOB_STATE_SIZE] __attribute__((aligned(8)));  // state for commands executed once
 
 // **************** Callback for included in CLI commands *****************
 static CLI_Result_t help_cmd();              // print help
 static CLI_Result_t reboot_mcu();            // reboot mcu
 static CLI_Result_t print_cli_w(void);       // print welcome screen
+#if (CLI_ULOG_EN == 1)
 static CLI_Result_t set_loglevel(void);      // set loglevel output
+#endif
+#if (CLI_CMD_STATS_EN == 1)
+static CLI_Result_t stats_cmd(void);         // print execute statistics
+#endif
+#if (CLI_SCHED_EN == 1)
+static CLI_Result_t every_cmd(void);         // periodic execute command
+static CLI_Result_t repeat_cmd(void);        // repeat execute command
+static CLI_Result_t jobs_cmd(void);          // print scheduled commands
+static CLI_Result_t kill_cmd(void);          // cancel scheduled command
+#endif
+#if (CLI_SCRIPT_EN == 1)
+static CLI_Result_t run_cmd(void);           // execute script
+#endif
+#if (CLI_VM_EN == 1)
+static CLI_Result_t vm_cmd(void);            // run bytecode program
+#endif
+#if (CLI_MEM_EN == 1)
+static CLI_Result_t md_cmd(void);            // memory dump
+static CLI_Result_t mr_cmd(void);            // memory read
+static CLI_Result_t mw_cmd(void);            // memory write
+#endif
+#if (CLI_MEM_STAT_EN == 1)
+static CLI_Result_t mem_cmd(void);           // memory footprint
+#endif
+#if (CLI_MACHINE_EN == 1)
+static CLI_Result_t machine_cmd(void);       // switch machine text mode
+#endif
 // ************************************************************************
 
 // ************************** static function *****************************
@@ -90,13 +180,17 @@ static int8_t _index_of_flag(const char *flag);
 static void _cli_print_time();
 static void _arg_destroy(CLI_Params_t* src);
 static uint8_t _strPartCmp(const char* str1, const char* str2);
+static const char* _get_line_word(uint8_t index);
+static const char* _get_word(const char *p, uint8_t index);
+static void _abort_foreground(CLI_FgJob_t *fg);
+static bool _copy_line_word(uint8_t index, char* buf);
 // ************************************************************************
 
 
 
 // ************************* interrupt function ***************************
 
-static bool _interrupt_operation = false; // todo: need implement - abort run current job
+#define _interrupt_operation            (CLI_State_s.session->interrupt)
 /** @brief Checking the status of the start of the operation (return, stator-on) */
 inline bool cli_get_int_state(void) {
 
@@ -105,16 +199,177 @@ inline bool cli_get_int_state(void) {
     return res;
 }
 
+#if (CLI_WATCHDOG_EN == 1)
+/** @brief Stage of watchdog for execute command */
+typedef enum{
+    WD_Off = 0,                         // no command with deadline executed
+    WD_Armed,                           // command executed before deadline
+    WD_Abort,                           // deadline exceeded, abort flag raised
+    WD_Escalated,                       // abort ignored, hook called
+}CLI_WdStage_t;
+
+static struct{
+    volatile uint32_t deadline;         // time of next stage in ms
+    volatile uint8_t stage;             // CLI_WdStage_t
+    const char *name;                   // name of watched command
+    void (*hook)(const char* name);     // escalation hook
+}CLI_Wd_s;
+
+void cli_watchdog_tick(void)
+{
+    uint8_t stage = CLI_Wd_s.stage;
+
+    if ((stage != WD_Armed) && (stage != WD_Abort))
+        return;
+
+    if ((int32_t) (CLI_GETMS() - CLI_Wd_s.deadline) < 0)
+        return;
+
+    if (stage == WD_Armed) {
+        // cooperative handlers leave on CLI_CHECK_ABORT
+        _interrupt_operation = true;
+        CLI_Wd_s.deadline += CLI_WATCHDOG_GRACE_MS;
+        CLI_Wd_s.stage = WD_Abort;
+    } else {
+        CLI_Wd_s.stage = WD_Escalated;
+        if (CLI_Wd_s.hook != NULL)
+            CLI_Wd_s.hook(CLI_Wd_s.name);
+    }
+}
+
+void cli_set_watchdog_hook(void (*hook)(const char* name))
+{
+    CLI_Wd_s.hook = hook;
+}
+#else
+void cli_watchdog_tick(void) {}
+void cli_set_watchdog_hook(void (*hook)(const char* name)) { (void) hook; }
+#endif
+
+// ************************************************************************
+
+// ************************** session function ****************************
+
+static void _session_bind(CLI_Session_t *s)
+{
+    CLI_State_s.session = s;
+    cli_input_bind(&s->input);
+    cli_log_bind(&s->history);
+}
+
+static void _session_init(CLI_Session_t *s, const CLI_Transport_t *transport, void *ctx)
+{
+    CLI_Session_t *prev = CLI_State_s.session;
+
+    s->transport = transport;
+    s->ctx = ctx;
+    s->write = NULL;
+    s->argv[0] = s->argName;
+    for (uint8_t i = 1; i < CLI_ARGS_BUF_SIZE; i++)
+        s->argv[i] = s->argData[i - 1];
+    s->inputArgs.argv = s->argv;
+    s->inputArgs.argc = 0;
+    s->fg.active = false;
+    s->fg.request = false;
+#if (CLI_SCRIPT_EN == 1)
+    s->fg.isScript = false;
+#endif
+    s->interrupt = false;
+    s->isEntered = false;
+    s->first_in = false;
+    s->open = true;
+
+    _session_bind(s);
+    cli_input_init();
+    cli_log_init();
+    _session_bind(prev);
+}
+
+CLI_Session_t* cli_session_open(const CLI_Transport_t *transport, void *ctx)
+{
+    for (uint8_t i = 1; i < CLI_SESSION_MAX; i++) {
+        CLI_Session_t *s = &_sessions[i];
+
+        if (s->open)
+            continue;
+
+        _session_init(s, transport, ctx);
+
+        CLI_Session_t *prev = CLI_State_s.session;
+        _session_bind(s);
+        PRINT_ARROW();
+        _session_bind(prev);
+
+        return s;
+    }
+
+    return NULL;
+}
+
+void cli_session_close(CLI_Session_t *s)
+{
+    if (s != CONSOLE) {
+        _abort_foreground(&s->fg);
+        s->open = false;
+    }
+}
+
+CLI_Append_Result_t cli_session_append_char(CLI_Session_t *s, char ch)
+{
+    CLI_Session_t *prev = CLI_State_s.session;
+
+    _session_bind(s);
+    CLI_Append_Result_t result = cli_append_char(ch);
+    _session_bind(prev);
+
+    return result;
+}
+
+CLI_Session_t* cli_session_get_current(void)
+{
+    return CLI_State_s.session;
+}
+
+CLI_Session_t* cli_session_get_console(void)
+{
+    return CONSOLE;
+}
+
+void cli_session_write(const char *data, size_t len)
+{
+    CLI_Session_t *s = CLI_State_s.session;
+
+    if (s->write != NULL)
+        s->write(data, len);
+    else
+        s->transport->write(s->ctx, data, len);
+}
+
+void cli_session_send(const char *data, size_t len)
+{
+    CLI_Session_t *s = CLI_State_s.session;
+
+    s->transport->write(s->ctx, data, len);
+}
+
+void cli_session_set_write(void (*write)(const char *data, size_t len))
+{
+    CLI_State_s.session->write = write;
+}
+
 // ************************************************************************
 
 // ************************** CLI function ********************************
 
 static void cli_welcome(void) {
 
+    uint32_t uid[3];
+    cli_port_get_uid(uid);
+
     CLI_PRINTF(SEPARATOR_ASTERISK);
     CLI_PRINTF("\r\n| %s\t\t\t\t\t  |", BUILD_NAME);
     CLI_PRINTF("\r\n| SW  ver: v%s.%s.%s    MCU: %s \t\t\t  |", MINOR, MAJOR, PATCH, MCU);
-    CLI_PRINTF("\r\n| CLI ver: %s    UID: %X-%X-%X\t  |", _TERM_VER_, UniqueID[0], UniqueID[1], UniqueID[2]);
+    CLI_PRINTF("\r\n| CLI ver: %s    UID: %X-%X-%X\t  |", _TERM_VER_, (unsigned int) uid[0], (unsigned int) uid[1], (unsigned int) uid[2]);
     CLI_PRINTF("\r\n| Build Date: %s %s Where: %s\t  |", __DATE__, __TIME__, _WHERE_BUILD);
     CLI_PRINTF("\r\n| Branch: %s GIT-HASH: %s\t\t\t  |", GIT_BRANCH, GIT_HASH);
     CLI_PRINTF(SEPARATOR_ASTERISK);
@@ -129,33 +384,67 @@ CLI_Result_t sys_uptime(void)
 /** @brief Terminal initialize */
 void cli_init(void)
 {
+    cli_port_init();
+
+#if (CLI_ULOG_EN == 1)
     /** Register external data logger */ // todo: need to integrate the logger into CLI
     ULOG_INIT();
     ULOG_SUBSCRIBE(console_logger, ULOG_DEBUG_LEVEL);
     ULOG_INFO("Logger init\n");
     /** ***************************** */
+#endif
 
-    cli_input_init();
+    _session_init(CONSOLE, &_consoleTransport, NULL);
+    _session_bind(CONSOLE);
 
     CLI_State_s.countCommand = 0;
     CLI_State_s.executeState = 0;
-    CLI_State_s.isEntered = false;
-
-    cli_add_new_cmd("help", help_cmd, 0, CLI_PrintNone, "help by CLI command");
-    cli_add_new_cmd("welcome", print_cli_w, 0, CLI_PrintNone, "CLI welcome message");
-    cli_add_new_cmd("boottime", sys_uptime, 0, CLI_PrintStartTime, "System BootTime");
-    cli_add_new_cmd("reboot", reboot_mcu, 0, CLI_PrintNone, "reboot MCU");
-#if (DEBUG == 1)
-    cli_add_new_cmd("loglevel", set_loglevel, 1, CLI_PrintNone, "for set LogLevel output");
+    CLI_State_s.line = NULL;
+    CLI_State_s.jobState = _scratch_state;
+    CLI_State_s.jobStep = 0;
+
+    cli_add_new_cmd("help", help_cmd, 0, CLI_PrintNone, CLI_DESCR(HELP, "help by CLI command"));
+    cli_add_new_cmd("welcome", print_cli_w, 0, CLI_PrintNone, CLI_DESCR(WELCOME, "CLI welcome message"));
+    cli_add_new_cmd("boottime", sys_uptime, 0, CLI_PrintStartTime, CLI_DESCR(BOOTTIME, "System BootTime"));
+    cli_add_new_cmd("reboot", reboot_mcu, 0, CLI_PrintNone, CLI_DESCR(REBOOT, "reboot MCU"));
+#if (CLI_CMD_STATS_EN == 1)
+    cli_stats_init();
+    cli_add_new_cmd("stats", stats_cmd, 0, CLI_PrintNone, CLI_DESCR(STATS, "command statistics [-v hist, -m machine, -r reset]"));
+#endif
+#if (CLI_SCHED_EN == 1)
+    cli_sched_init();
+    cli_add_new_cmd("every", every_cmd, 0, CLI_PrintNone, CLI_DESCR(EVERY, "every <period>[ms|s] <cmd>"));
+    cli_add_new_cmd("repeat", repeat_cmd, 0, CLI_PrintNone, CLI_DESCR(REPEAT, "repeat <N> [<period>[ms|s]] <cmd>"));
+    cli_add_new_cmd("jobs", jobs_cmd, 0, CLI_PrintNone, CLI_DESCR(JOBS, "list scheduled and background commands"));
+    cli_add_new_cmd("kill", kill_cmd, 1, CLI_PrintNone, CLI_DESCR(KILL, "kill <id> scheduled or background command"));
+#endif
+#if (CLI_SCRIPT_EN == 1)
+    cli_add_new_cmd("run", run_cmd, 0, CLI_PrintNone, CLI_DESCR(RUN, "run <script> execute script"));
+#endif
+#if (CLI_VM_EN == 1)
+    cli_vm_init();
+    cli_add_new_cmd("vm", vm_cmd, 0, CLI_PrintNone, CLI_DESCR(VM, "vm [<program> | -k] run or stop program"));
+#endif
+#if (CLI_MEM_EN == 1)
+    cli_add_new_cmd("md", md_cmd, 0, CLI_PrintNone, CLI_DESCR(MD, "md <addr> [<count>] [-8|-16|-32] memory dump, 32-bit units by default"));
+    cli_add_new_cmd("mr", mr_cmd, 0, CLI_PrintNone, CLI_DESCR(MR, "mr <addr> [-8|-16|-32] memory read, 32-bit by default"));
+    cli_add_new_cmd("mw", mw_cmd, 0, CLI_PrintNone, CLI_DESCR(MW, "mw <addr> <value> [<count>] [-8|-16|-32] memory write, 32-bit units by default"));
+#endif
+#if (CLI_MEM_STAT_EN == 1)
+    cli_add_new_cmd("mem", mem_cmd, 0, CLI_PrintNone, CLI_DESCR(MEM, "mem [stack on|off] RAM of CLI subsystems and stack high-water of commands"));
+#endif
+#if (CLI_MACHINE_EN == 1)
+    cli_add_new_cmd("machine", machine_cmd, 1, CLI_PrintNone, CLI_DESCR(MACHINE, "machine on|off no echo and prompt, replies #tag status output"));
+#endif
+#if (DEBUG == 1) && (CLI_ULOG_EN == 1)
+    cli_add_new_cmd("loglevel", set_loglevel, 1, CLI_PrintNone, CLI_DESCR(LOGLEVEL, "for set LogLevel output"));
 #endif
 
     CLI_PRINTF("\r\n");
 
-    CLI_State_s.inputArgs.argv = (char **) cli_malloc(sizeof(char *) * CLI_ARGS_BUF_SIZE);
-    for (uint8_t i = 0; i < CLI_ARGS_BUF_SIZE; i++)
-        CLI_State_s.inputArgs.argv[i] = cli_malloc(sizeof(char) * (CLI_ARG_SIZE + 1));
-
-    cli_log_init();
+#if (DEBUG == 1) && (CLI_LOG_RATE_LIMIT_EN == 1)
+    cli_log_rl_init();
+#endif
 
     PRINT_ARROW();
 }
@@ -167,8 +456,8 @@ void cli_init(void)
 int8_t _index_of_flag(const char *flag)
 {
 
-    for (uint8_t i = 0; i < CLI_State_s.inputArgs.argc; i++) {
-        if ( _strcmp(CLI_State_s.inputArgs.argv[i], flag)) {
+    for (uint8_t i = 0; i < CLI_State_s.session->inputArgs.argc; i++) {
+        if ( _strcmp(CLI_State_s.session->inputArgs.argv[i], flag)) {
             return i;
         }
     }
@@ -180,8 +469,7 @@ int8_t _index_of_flag(const char *flag)
 uint8_t _strPartCmp(const char* str1, const char* str2)
 {
     uint8_t co = 0;
-    while(((str1 + co) != NULL) && (*(str1 + co) != '\0') &&
-          ((str2 + co) != NULL) && (*(str2 + co) != '\0')){
+    while((str1[co] != '\0') && (str2[co] != '\0')){
 
         if (str1[co] != str2[co])
             return 0;
@@ -193,6 +481,64 @@ uint8_t _strPartCmp(const char* str1, const char* str2)
 }
 
 
+/**
+ * @brief Get word by index in command string of current execute command
+ * @param index - index word, 0 - command name
+ * @return pointer on word (until end of string) or NULL
+* */
+const char* _get_line_word(uint8_t index)
+{
+    return _get_word(CLI_State_s.line, index);
+}
+
+/**
+ * @brief Get word by index in command string
+ * @param p - command string or NULL
+ * @param index - index word, 0 - command name
+ * @return pointer on word (until end of string) or NULL
+* */
+const char* _get_word(const char *p, uint8_t index)
+{
+    if (p == NULL)
+        return NULL;
+
+    while (*p == ' ')
+        p++;
+
+    for (; index > 0; index--) {
+        while ((*p != '\0') && (*p != ' '))
+            p++;
+        while (*p == ' ')
+            p++;
+    }
+
+    return (*p != '\0') ? p : NULL;
+}
+
+/**
+ * @brief Copy word by index in command string of current execute command
+ * @param index - index word, 0 - command name
+ * @param buf - output buffer, CLI_CMD_BUF_SIZE + 1 bytes
+ * @return false if no word
+* */
+bool _copy_line_word(uint8_t index, char* buf)
+{
+    const char *word = _get_line_word(index);
+    uint8_t len = 0;
+
+    if (word == NULL)
+        return false;
+
+    while ((word[len] != '\0') && (word[len] != ' ') && (len < CLI_CMD_BUF_SIZE)) {
+        buf[len] = word[len];
+        len++;
+    }
+    buf[len] = '\0';
+
+    return true;
+}
+
+
 uint16_t _getCountSeparator(const char* strSrc, const char* separator)
 {
     uint8_t i = 0;
@@ -224,7 +570,7 @@ void _split(char* strSrc, const char* separator, CLI_Params_t* dst)
     uint8_t count_sep = _getCountSeparator(strSrc, separator);
     uint16_t lenSep = _strlen((char*)separator);
 
-    dst->argc = count_sep;
+    dst->argc = (count_sep < CLI_ARGS_BUF_SIZE) ? count_sep : CLI_ARGS_BUF_SIZE;
 
     int start_index = 0;
     int size_word = 0;
@@ -240,9 +586,14 @@ void _split(char* strSrc, const char* separator, CLI_Params_t* dst)
             if((strSrc[co] == separator[s]) || (strSrc[co] == '\0'))
             {
                 size_word = co - start_index;
+                int max_word = (co_arg == 0) ? CLI_CMD_BUF_SIZE : CLI_ARG_SIZE;
+                if (size_word > max_word)
+                    size_word = max_word;       // long argument (address, value) is truncated, full word by _get_line_word
 
-                dst->argv[co_arg][size_word] = '\0';
-                _strcpy(strSrc, start_index, dst->argv[co_arg], 0, size_word);
+                if (co_arg < CLI_ARGS_BUF_SIZE) {
+                    dst->argv[co_arg][size_word] = '\0';
+                    _strcpy(strSrc, start_index, dst->argv[co_arg], 0, size_word);
+                }
 
                 start_index = co + 1;
                 co_arg++;
@@ -263,25 +614,25 @@ void _split(char* strSrc, const char* separator, CLI_Params_t* dst)
 
 inline char* cli_get_arg(uint8_t index)
 {
-    return CLI_State_s.inputArgs.argv[index + 1];
+    return CLI_State_s.session->inputArgs.argv[index + 1];
 }
 
 /** @brief Get argument in Dec */
 inline uint32_t cli_get_arg_dec(uint8_t index)
 {
-    return CLI_GetDecString(CLI_State_s.inputArgs.argv[index + 1]);
+    return CLI_GetDecString(CLI_State_s.session->inputArgs.argv[index + 1]);
 }
 
 /** @brief Get argument in Hex */
 inline uint32_t cli_get_arg_hex(uint8_t index)
 {
-    return CLI_GetHexString(CLI_State_s.inputArgs.argv[index + 1]);
+    return CLI_GetHexString(CLI_State_s.session->inputArgs.argv[index + 1]);
 }
 
 /** @brief Get argument in str */
 int cli_get_arg_str(uint8_t index, char *str)
 {
-    return _strcmp(CLI_State_s.inputArgs.argv[index + 1], str);
+    return _strcmp(CLI_State_s.session->inputArgs.argv[index + 1], str);
 }
 
 bool cli_get_arg_dec_by_flag(const char *flag, uint32_t *outValue)
@@ -289,7 +640,7 @@ bool cli_get_arg_dec_by_flag(const char *flag, uint32_t *outValue)
 
     int8_t w = _index_of_flag(flag);
 
-    if ((w > 0) && (w + 1 < CLI_State_s.inputArgs.argc)) {
+    if ((w > 0) && (w + 1 < CLI_State_s.session->inputArgs.argc)) {
         *outValue = cli_get_arg_dec(w);
         return true;
     }
@@ -302,7 +653,7 @@ bool cli_get_arg_hex_by_flag(const char *flag, uint32_t *outValue)
 
     int8_t w = _index_of_flag(flag);
 
-    if ((w > 0) && (w + 1 < CLI_State_s.inputArgs.argc)) {
+    if ((w > 0) && (w + 1 < CLI_State_s.session->inputArgs.argc)) {
         *outValue = cli_get_arg_hex(w);
         return true;
     }
@@ -336,13 +687,57 @@ CLI_Result_t _execute_cli_cmd(char **argv, uint8_t argc)
                 return CLI_ArgErr;
         }
 
-        CLI_State_s.executeState = 1;
+        CLI_State_s.executeState++;
+        uint32_t arenaMark = cli_arena_mark();
 
         if ( cmd->mode & CLI_PrintStartTime )
             _cli_print_time();
 
         uint32_t startMs = CLI_GETMS();
+        bool overrun = false;
+#if (CLI_WATCHDOG_EN == 1)
+        // watch outer command with deadline, nested commands run in its budget
+        bool watched = (cmd->deadlineMs != 0) && (CLI_Wd_s.stage == WD_Off);
+        if (watched) {
+            CLI_Wd_s.name = cmd->name;
+            CLI_Wd_s.deadline = startMs + cmd->deadlineMs;
+            CLI_Wd_s.stage = WD_Armed;
+        }
+#endif
+#if (CLI_STACK_PAINT_EN == 1)
+        // nested commands run on stack of outer command, painting costs every command: only on request
+        bool painted = (CLI_State_s.executeState == 1) && cli_mem_stack_is_armed();
+        if (painted)
+            cli_mem_stack_paint();
+#endif
+#if (CLI_CMD_STATS_EN == 1)
+        uint32_t startCycles = cli_stats_get_cycles();
+#endif
         CLI_Result_t result = cmd->fcn(argv, argc);
+#if (CLI_STACK_PAINT_EN == 1)
+        if (painted) {
+            uint32_t used = cli_mem_stack_used();
+            if (used > cmd->stackMax)
+                cmd->stackMax = (uint16_t) used;
+        }
+#endif
+#if (CLI_CMD_STATS_EN == 1)
+        uint32_t cycles = cli_stats_get_cycles() - startCycles;
+#endif
+#if (CLI_WATCHDOG_EN == 1)
+        if (watched) {
+            overrun = (CLI_Wd_s.stage != WD_Armed);
+            CLI_Wd_s.stage = WD_Off;
+            if (overrun) {
+                _interrupt_operation = false;   // abort flag not consumed by handler
+                CLI_PRINTF("\r\n%s: deadline %u ms exceeded", cmd->name, (unsigned int) cmd->deadlineMs);
+            }
+        }
+#endif
+#if (CLI_CMD_STATS_EN == 1)
+        cli_stats_update(&cmd->stats, cycles, result, overrun);
+#endif
+        (void) overrun;
         uint32_t stopMs = CLI_GETMS();
 
         if ( cmd->mode & CLI_PrintStopTime )
@@ -353,7 +748,8 @@ CLI_Result_t _execute_cli_cmd(char **argv, uint8_t argc)
             _print_boot_time(&t);
         }
 
-        CLI_State_s.executeState = 0;
+        cli_arena_release(arenaMark);
+        CLI_State_s.executeState--;
 
         return result;
     }
@@ -361,36 +757,316 @@ CLI_Result_t _execute_cli_cmd(char **argv, uint8_t argc)
     return CLI_NotFound;
 }
 
+CLI_Result_t cli_execute_step(const char *str, void *state, uint16_t step)
+{
+    const char *prevLine = CLI_State_s.line;
+    void *prevState = CLI_State_s.jobState;
+    uint16_t prevStep = CLI_State_s.jobStep;
+
+    CLI_State_s.line = str;
+    CLI_State_s.jobState = state;
+    CLI_State_s.jobStep = step;
+
+    _split((char *) str, " ", (CLI_Params_t *) &CLI_State_s.session->inputArgs);
+
+    CLI_Result_t result = _execute_cli_cmd(CLI_State_s.session->inputArgs.argv, CLI_State_s.session->inputArgs.argc);
+
+    _arg_destroy((CLI_Params_t *) &CLI_State_s.session->inputArgs);
+
+    CLI_State_s.line = prevLine;
+    CLI_State_s.jobState = prevState;
+    CLI_State_s.jobStep = prevStep;
+
+    return result;
+}
+
+CLI_Result_t cli_execute(const char *str)
+{
+    cli_memset(_scratch_state, 0, CLI_JOB_STATE_SIZE);
+    return cli_execute_step(str, _scratch_state, 0);
+}
+
+inline void* cli_get_job_state(void)
+{
+    return CLI_State_s.jobState;
+}
+
+inline uint16_t cli_get_job_step(void)
+{
+    return CLI_State_s.jobStep;
+}
+
+const char* cli_get_cmd_name(uint16_t index)
+{
+    return (index < CLI_State_s.countCommand) ? CLI_State_s.cmds[index].name : NULL;
+}
+
+uint16_t cli_get_cmd_count(void)
+{
+    return CLI_State_s.countCommand;
+}
+
+#if (CLI_SCHED_EN == 1)
 /**
- * @brief Execute command
- * @param str command const string include arguments
- * @return result execute command
+ * @brief Start command as background job if string ends with '&'
+ * @return true if command string is background command
 * */
-CLI_Result_t ExecuteString(const char *str)
+static bool _start_background(const char *str)
 {
+    uint32_t len = _strlen(str);
+
+    while ((len > 0) && (str[len - 1] == ' '))
+        len--;
 
-    _split((char *) str, " ", (CLI_Params_t *) &CLI_State_s.inputArgs);
+    if ((len == 0) || (str[len - 1] != '&'))
+        return false;
 
-    CLI_Result_t result = _execute_cli_cmd(CLI_State_s.inputArgs.argv, CLI_State_s.inputArgs.argc);
+    len--;
+    while ((len > 0) && (str[len - 1] == ' '))
+        len--;
 
-    _arg_destroy((CLI_Params_t *) &CLI_State_s.inputArgs);
+    char cmd[CLI_CMD_BUF_SIZE + 1];
+    cli_memcpy(cmd, str, len);
+    cmd[len] = '\0';
+
+    int8_t id = cli_sched_add_task(cmd);
+    if (id < 0)
+        CLI_PRINTF("\r\nNo free job slot")
+    else
+        CLI_PRINTF("\r\n[%d] %s", (int) id, cmd)
 
+    return true;
+}
+#endif
+
+/** @brief Finish foreground command: print result and prompt */
+static void _finish_foreground(CLI_Result_t result)
+{
+#if (CLI_MACHINE_EN == 1)
+    CLI_FgJob_t *fg = &CLI_State_s.session->fg;
+
+    if (fg->request) {
+        fg->request = false;
+        cli_machine_end(result);
+        return;
+    }
+#endif
 #if (CLI_PRINT_ERROR_EXEC_EN == 1)
     _print_result_exec(result);
 #endif
 
     PRINT_ARROW();
+}
+
+#if (CLI_SCRIPT_EN == 1)
+static void _print_run_status(const char *name, const CLI_ScriptStatus_t *st, CLI_Result_t result)
+{
+    if (st->errLine)
+        CLI_PRINTF("\r\nrun %s: line %u failed (%d), %u lines, %u commands", name, (unsigned int) st->errLine,
+                   (int) st->result, (unsigned int) st->lines, (unsigned int) st->commands)
+    else if (result == CLI_OK)
+        CLI_PRINTF("\r\nrun %s: OK, %u lines, %u commands", name, (unsigned int) st->lines, (unsigned int) st->commands)
+    else
+        CLI_PRINTF("\r\nrun %s: failed (%d)", name, (int) result)
+}
+#endif
+
+/** @brief Execute next step of foreground command, chain or script */
+static CLI_Result_t _foreground_step(CLI_FgJob_t *fg)
+{
+#if (CLI_SCRIPT_EN == 1)
+    if (fg->isScript) {
+        CLI_Result_t result = cli_script_step(&fg->script);
+
+        if (result != CLI_Continue) {
+            fg->isScript = false;
+            // fg->cmd is "run <name>" or chain itself
+            if (!fg->script.chain)
+                _print_run_status(_get_word(fg->cmd, 1), &fg->script.st, result);
+        }
+        return result;
+    }
+#endif
+
+    CLI_Result_t result = cli_execute_step(fg->cmd, fg->state, fg->step);
+
+    if ((result == CLI_Continue) && (fg->step < UINT16_MAX))
+        fg->step++;
 
     return result;
 }
 
-/** @brief Execute CLI */
-bool cli_loop_service(void)
+/** @brief Stop foreground command without its last step */
+static void _abort_foreground(CLI_FgJob_t *fg)
+{
+    fg->active = false;
+#if (CLI_SCRIPT_EN == 1)
+    if (fg->isScript) {
+        fg->isScript = false;
+        cli_script_abort(&fg->script);
+    }
+#endif
+}
+
+/**
+ * @brief Execute first step of foreground command or chain
+ * @return result of step, CLI_Continue - next steps in _session_service
+* */
+static CLI_Result_t _start_foreground(const char *str)
+{
+    CLI_FgJob_t *fg = &CLI_State_s.session->fg;
+    uint32_t len = _strlen(str);
+
+    if (len > CLI_CMD_BUF_SIZE)
+        return CLI_ArgErr;
+
+    cli_memcpy(fg->cmd, str, len + 1);
+    cli_memset(fg->state, 0, CLI_JOB_STATE_SIZE);
+    fg->step = 0;
+
+#if (CLI_SCRIPT_EN == 1)
+    if (cli_script_is_chain(fg->cmd)) {
+        cli_script_begin(&fg->script, fg->cmd, len, true);
+        fg->isScript = true;
+    }
+#endif
+
+    CLI_Result_t result = _foreground_step(fg);
+    fg->active = (result == CLI_Continue);
+
+    return result;
+}
+
+/**
+ * @brief Execute command
+ * @param str command const string include arguments
+ * @return result execute command
+* */
+CLI_Result_t ExecuteString(const char *str)
+{
+    _interrupt_operation = false;       // drop Ctrl+C pressed before command
+
+#if (CLI_SCHED_EN == 1)
+    if (_start_background(str)) {
+        PRINT_ARROW();
+        return CLI_OK;
+    }
+#endif
+
+    CLI_Result_t result = _start_foreground(str);
+
+    // prompt will be printed after last step
+    if (result != CLI_Continue)
+        _finish_foreground(result);
+
+    return result;
+}
+
+#if (CLI_MACHINE_EN == 1)
+/**
+ * @brief Execute queued request of machine mode, resumable command continues as
+ *        foreground command, reply is sent after its last step
+ * @return false if no request
+* */
+static bool _execute_request(void)
 {
+    const char *str = cli_machine_begin();
+
+    if (str == NULL)
+        return false;
+
+    _interrupt_operation = false;
+    CLI_Result_t result = CLI_Continue;
+
+#if (CLI_SCHED_EN == 1)
+    if (_start_background(str))
+        result = CLI_OK;
+#endif
+    if (result == CLI_Continue) {
+        result = _start_foreground(str);
+        if (result == CLI_Continue) {
+            // output of jobs between steps is not part of reply
+            cli_machine_capture(false);
+            CLI_State_s.session->fg.request = true;
+            return true;
+        }
+    }
+
+    cli_machine_end(result);
+
+    return true;
+}
+#endif
+
+/**
+ * @brief Service of session: foreground command, received line or request
+ * @return true if line or request executed
+* */
+static bool _session_service(CLI_Session_t *s)
+{
+    CLI_FgJob_t *fg = &s->fg;
+
+    // Ctrl+C between steps: abort foreground command, on console also periodic commands,
+    // flag is consumed here so background tasks do not see it on their next step
+    if (s->interrupt) {
+        s->interrupt = false;
+        if (s == CONSOLE) {
+#if (CLI_SCHED_EN == 1)
+            cli_sched_cancel_all(false);
+#endif
+#if (CLI_VM_EN == 1)
+            cli_vm_stop_all();
+#endif
+        }
+        if (fg->active) {
+            _abort_foreground(fg);
+            _finish_foreground(CLI_WorkInt);
+        }
+    }
+
+    if (fg->active) {
+#if (CLI_MACHINE_EN == 1)
+        cli_machine_capture(fg->request);
+#endif
+        CLI_Result_t result = _foreground_step(fg);
+#if (CLI_MACHINE_EN == 1)
+        cli_machine_capture(false);
+#endif
+
+        if (result != CLI_Continue) {
+            fg->active = false;
+            _finish_foreground(result);
+        }
+    }
+
+    // jobs and programs print to console
+    if (s == CONSOLE) {
+        bool redraw = false;
+#if (CLI_SCHED_EN == 1)
+        redraw |= (cli_sched_service() != 0);
+#endif
+#if (CLI_VM_EN == 1)
+        redraw |= cli_vm_service();
+#endif
+        if (redraw && !fg->active) {
+            // redraw input line after output of jobs
+            CLI_PRINTF(STRING_TERM_ENTER);
+            cli_input_refresh(cli_input_get_buffer(MainBuffer));
+        }
+    }
+
+#if (CLI_RPC_EN == 1)
+    if (cli_rpc_service())
+        return true;
+#endif
+#if (CLI_MACHINE_EN == 1)
+    if (!fg->active && _execute_request())
+        return true;
+#endif
 
-    if (CLI_State_s.isEntered == true ) {
+    if ((s->isEntered == true) && !fg->active) {
         ExecuteString((const char *) cli_input_get_buffer(TransitBuffer));
-        CLI_State_s.isEntered = false;
+        s->isEntered = false;
 
         return true;
     }
@@ -398,6 +1074,43 @@ bool cli_loop_service(void)
     return false;
 }
 
+/** @brief Execute CLI */
+bool cli_loop_service(void)
+{
+    bool executed = false;
+
+#if (DEBUG == 1) && (CLI_LOG_RATE_LIMIT_EN == 1)
+    cli_log_rl_service();
+#endif
+
+    for (uint8_t i = 0; i < CLI_SESSION_MAX; i++) {
+        CLI_Session_t *s = &_sessions[i];
+
+        if (!s->open)
+            continue;
+
+        _session_bind(s);
+
+        if (s->transport->read != NULL) {
+            char buf[CLI_SESSION_READ_SIZE];
+            size_t n = s->transport->read(s->ctx, buf, sizeof(buf));
+
+            // every line of block is executed
+            for (size_t k = 0; k < n; k++) {
+                if (cli_append_char(buf[k]) == CLI_APPEND_Enter)
+                    executed |= _session_service(s);
+            }
+        }
+
+        executed |= _session_service(s);
+    }
+
+    // console is current between calls: cli_append_char, RX interrupt
+    _session_bind(CONSOLE);
+
+    return executed;
+}
+
 /**
  * @brief Add command
  * @param name - input name
@@ -425,24 +1138,49 @@ CLI_Add_Result_t cli_add_new_cmd(const char *name, CLI_Result_t (*fcn)(), uint8_
         return ADD_CMD_EmptyName;
     }
 
-    uint8_t i = 0;
+    uint16_t i = 0;
     for (; i < CLI_State_s.countCommand; i++)
         if ( _strcmp((char *) CLI_State_s.cmds[i].name, (char *) name)) {
             _print_result_add_cmd(ADD_CMD_RetryName);
             return ADD_CMD_RetryName;
         }
 
-    uint8_t countCmd = CLI_State_s.countCommand;
+    uint16_t countCmd = CLI_State_s.countCommand;
     CLI_State_s.cmds[countCmd].fcn = fcn;
     CLI_State_s.cmds[countCmd].name = name;
     CLI_State_s.cmds[countCmd].argc = argc;
     CLI_State_s.cmds[countCmd].mode = mode;
     CLI_State_s.cmds[countCmd].description = descr;
+#if (CLI_WATCHDOG_EN == 1)
+    CLI_State_s.cmds[countCmd].deadlineMs = CLI_DEFAULT_DEADLINE_MS;
+#endif
+#if (CLI_CMD_STATS_EN == 1)
+    cli_stats_reset(&CLI_State_s.cmds[countCmd].stats);
+#endif
+#if (CLI_STACK_PAINT_EN == 1)
+    CLI_State_s.cmds[countCmd].stackMax = 0;
+#endif
     CLI_State_s.countCommand++;
 
     return ADD_CMD_OK;
 }
 
+bool cli_set_cmd_deadline(const char *name, uint32_t deadlineMs)
+{
+    CLI_Cmd_t *cmd = _find_cli_command(name);
+
+    if (cmd == NULL)
+        return false;
+
+#if (CLI_WATCHDOG_EN == 1)
+    cmd->deadlineMs = deadlineMs;
+#else
+    (void) deadlineMs;
+#endif
+
+    return true;
+}
+
 /**
  * @brief Print result execute command
  * @param code - result code
@@ -501,7 +1239,7 @@ static void _print_result_add_cmd(uint8_t code)
  * */
 CLI_Cmd_t *_find_cli_command(const char *cmdName)
 {
-    uint8_t i = 0;
+    uint16_t i = 0;
     for (; i < CLI_State_s.countCommand; i++) {
         char *name1 = (char *) CLI_State_s.cmds[i].name;
         char *name2 = (char *) cmdName;
@@ -523,7 +1261,7 @@ CLI_Cmd_t *_find_part_term_cmd(const char *cmdName)
 {
     CLI_Cmd_t *result = NULL;
 
-    uint8_t i = 0;
+    uint16_t i = 0;
     for (; i < CLI_State_s.countCommand; i++) {
         char *name1 = (char *) CLI_State_s.cmds[i].name;
         char *name2 = (char *) cmdName;
@@ -551,7 +1289,13 @@ CLI_Result_t help_cmd()
     CLI_PRINTF(SEPARATOR);
 
     for (uint16_t i = 0; i < CLI_State_s.countCommand; i++) {
-        CLI_PRINTF("\r\n%-10s - %s", CLI_State_s.cmds[i].name, CLI_State_s.cmds[i].description);
+        // description is decoded into output, stripped description - only name
+        if (CLI_State_s.cmds[i].description != NULL) {
+            CLI_PRINTF("\r\n%-10s - ", CLI_State_s.cmds[i].name);
+            cli_descr_print(CLI_State_s.cmds[i].description);
+        } else {
+            CLI_PRINTF("\r\n%s", CLI_State_s.cmds[i].name);
+        }
         CLI_PRINTF(SEPARATOR);
     }
 
@@ -561,8 +1305,8 @@ CLI_Result_t help_cmd()
 CLI_Result_t reboot_mcu(void)
 {
     CLI_PRINTF("\r\nreset MCU\r\n")
-    HAL_Delay(1000);
-    HAL_NVIC_SystemReset();
+    cli_port_delay_ms(1000);
+    cli_port_reset();
     return CLI_OK;
 }
 
@@ -572,6 +1316,420 @@ CLI_Result_t print_cli_w(void)
     return CLI_OK;
 }
 
+#if (CLI_CMD_STATS_EN == 1)
+CLI_Result_t stats_cmd(void)
+{
+    if (cli_is_arg_flag("-r")) {
+        for (uint16_t i = 0; i < CLI_State_s.countCommand; i++)
+            cli_stats_reset(&CLI_State_s.cmds[i].stats);
+
+        CLI_PRINTF("\r\nstatistics reset");
+        return CLI_OK;
+    }
+
+    bool machine = cli_is_arg_flag("-m");
+    bool hist = cli_is_arg_flag("-v");
+
+    cli_stats_print_header(machine);
+    for (uint16_t i = 0; i < CLI_State_s.countCommand; i++)
+        cli_stats_print(CLI_State_s.cmds[i].name, &CLI_State_s.cmds[i].stats, machine, hist);
+
+    return CLI_OK;
+}
+#endif
+
+#if (CLI_SCHED_EN == 1)
+/**
+ * @brief Parse period "100ms", "2s" or "100" (ms)
+ * @return true if word is period
+* */
+static bool _parse_period(const char *str, uint32_t *outMs)
+{
+    char *end;
+    uint32_t value = (uint32_t) strtoul(str, &end, 10);
+
+    if (end == str)
+        return false;
+
+    if ((end[0] == 'm') && (end[1] == 's')) {
+        end += 2;
+    } else if (end[0] == 's') {
+        value *= 1000;
+        end++;
+    }
+
+    if ((*end != ' ') && (*end != '\0'))
+        return false;
+
+    *outMs = value;
+    return true;
+}
+
+static CLI_Result_t _add_job(const char *cmd, uint32_t periodMs, uint32_t count)
+{
+    int8_t id = cli_sched_add(cmd, periodMs, count);
+
+    if (id < 0) {
+        CLI_PRINTF("\r\nNo free job slot");
+        return CLI_ExecErr;
+    }
+
+    CLI_PRINTF("\r\n[%d] %s", (int) id, cmd);
+    return CLI_OK;
+}
+
+CLI_Result_t every_cmd(void)
+{
+    uint32_t periodMs;
+    const char *period = _get_line_word(1);
+    const char *cmd = _get_line_word(2);
+
+    if ((period == NULL) || (cmd == NULL) || !_parse_period(period, &periodMs) || (periodMs == 0))
+        return CLI_ArgErr;
+
+    return _add_job(cmd, periodMs, 0);
+}
+
+CLI_Result_t repeat_cmd(void)
+{
+    char *end;
+    uint32_t periodMs = 0;
+    const char *countStr = _get_line_word(1);
+    const char *cmd = _get_line_word(2);
+
+    if ((countStr == NULL) || (cmd == NULL))
+        return CLI_ArgErr;
+
+    uint32_t count = (uint32_t) strtoul(countStr, &end, 10);
+    if ((end == countStr) || (*end != ' ') || (count == 0))
+        return CLI_ArgErr;
+
+    if (_parse_period(cmd, &periodMs))
+        cmd = _get_line_word(3);
+
+    if (cmd == NULL)
+        return CLI_ArgErr;
+
+    return _add_job(cmd, periodMs, count);
+}
+
+CLI_Result_t jobs_cmd(void)
+{
+    cli_sched_print();
+    return CLI_OK;
+}
+
+CLI_Result_t kill_cmd(void)
+{
+    if (!cli_sched_cancel((uint8_t) cli_get_arg_dec(0))) {
+        CLI_PRINTF("\r\nNo such job");
+        return CLI_ArgErr;
+    }
+
+    return CLI_OK;
+}
+#endif
+
+#if (CLI_SCRIPT_EN == 1)
+CLI_Result_t run_cmd(void)
+{
+    static uint8_t depth = 0;   // nested "run" in blocking script
+    char name[CLI_CMD_BUF_SIZE + 1];
+    CLI_FgJob_t *fg = &CLI_State_s.session->fg;
+
+    if (!_copy_line_word(1, name))
+        return CLI_ArgErr;
+
+    CLI_ScriptStatus_t st = {0, 0, 0, CLI_NotFound};
+    CLI_Result_t result = CLI_NotFound;
+    const char *script = cli_script_find(name);
+
+    if (!fg->isScript && (cli_get_job_state() == fg->state)) {
+        // foreground "run": one line per loop pass, summary after last line
+        if (script != NULL) {
+            cli_script_begin(&fg->script, script, _strlen(script), false);
+            result = CLI_OK;
+        }
+#if (CLI_SCRIPT_FILE_EN == 1)
+        else {
+            result = cli_script_begin_file(&fg->script, name);
+        }
+#endif
+        if (result == CLI_OK) {
+            fg->isScript = true;
+            return CLI_Continue;
+        }
+    } else if (depth >= CLI_SCRIPT_DEPTH_MAX) {
+        CLI_PRINTF("\r\nrun %s: nesting limit %u reached", name, (unsigned int) CLI_SCRIPT_DEPTH_MAX);
+        return CLI_ExecErr;
+    } else {
+        // nested in script, scheduled or background: up to end
+        depth++;
+        if (script != NULL)
+            result = cli_script_run(script, _strlen(script), &st);
+#if (CLI_SCRIPT_FILE_EN == 1)
+        else
+            result = cli_script_run_file(name, &st);
+#endif
+        depth--;
+    }
+
+    if ((result == CLI_NotFound) && (st.errLine == 0)) {
+        CLI_PRINTF("\r\nScript not found");
+        return CLI_ArgErr;
+    }
+
+    _print_run_status(name, &st, result);
+
+    return result;
+}
+#endif
+
+#if (CLI_VM_EN == 1)
+CLI_Result_t vm_cmd(void)
+{
+    char name[CLI_CMD_BUF_SIZE + 1];
+
+    if (!_copy_line_word(1, name)) {
+        cli_vm_print();
+        return CLI_OK;
+    }
+
+    if (_strcmp(name, "-k")) {
+        cli_vm_stop_all();
+        return CLI_OK;
+    }
+
+    CLI_Result_t result = cli_vm_start(name);
+
+    if (result == CLI_NotFound)
+        CLI_PRINTF("\r\nProgram not found")
+    else if (result != CLI_OK)
+        CLI_PRINTF("\r\nNo free slot, stop running program with \"vm -k\"")
+
+    return result;
+}
+#endif
+
+#if (CLI_MEM_EN == 1)
+/**
+ * @brief Parse arguments of memory commands: numbers and width flag -8, -16, -32
+ * @param values - output numbers, first hexCount numbers in hex, other in dec
+ * @param maxValues - max count of numbers
+ * @param hexCount - count of numbers in hex (address, value)
+ * @param width - input default width, output width in bytes
+ * @return count of numbers or -1
+* */
+static int8_t _parse_mem_args(uint32_t *values, uint8_t maxValues, uint8_t hexCount, uint8_t *width)
+{
+    int8_t count = 0;
+    const char *word;
+
+    for (uint8_t i = 1; (word = _get_line_word(i)) != NULL; i++) {
+        char *end;
+
+        if (word[0] == '-') {
+            uint32_t bits = (uint32_t) strtoul(word + 1, &end, 10);
+            if (((*end != ' ') && (*end != '\0')) || ((bits != 8) && (bits != 16) && (bits != 32)))
+                return -1;
+
+            *width = (uint8_t) (bits / 8);
+            continue;
+        }
+
+        if (count >= maxValues)
+            return -1;
+
+        values[count] = (uint32_t) strtoul(word, &end, (count < hexCount) ? 16 : 10);
+        if ((end == word) || ((*end != ' ') && (*end != '\0')))
+            return -1;
+
+        count++;
+    }
+
+    return count;
+}
+
+CLI_Result_t md_cmd(void)
+{
+    uint32_t arg[2];
+    uint8_t width = 4;
+    int8_t count = _parse_mem_args(arg, 2, 1, &width);
+
+    if (count < 1)
+        return CLI_ArgErr;
+
+    if (count < 2)
+        arg[1] = CLI_MEM_DUMP_DEFAULT / width;
+
+    // RPC: memory bytes (little endian units) instead of rows, cut to response size
+    if (cli_rpc_in_request()) {
+        for (uint32_t i = 0; i < arg[1]; i++) {
+            uint32_t v;
+            uint8_t le[4] = {0};
+
+            if (!cli_mem_read((uintptr_t) (arg[0] + i * width), width, &v))
+                return CLI_ArgErr;
+            for (uint8_t b = 0; b < width; b++)
+                le[b] = (uint8_t) (v >> (b * 8U));
+            if (!cli_rpc_put_bytes(le, width))
+                break;
+        }
+        return CLI_OK;
+    }
+
+    return cli_mem_dump((uintptr_t) arg[0], arg[1], width);
+}
+
+CLI_Result_t mr_cmd(void)
+{
+    uint32_t addr, value;
+    uint8_t width = 4;
+
+    if (_parse_mem_args(&addr, 1, 1, &width) != 1)
+        return CLI_ArgErr;
+
+    if (!cli_mem_read((uintptr_t) addr, width, &value))
+        return CLI_ArgErr;
+
+    if (cli_rpc_put_u32(CLI_RPC_ARG_HEX, value))
+        return CLI_OK;
+
+    CLI_PRINTF("\r\n%08X: %0*X", (unsigned int) addr, (int) width * 2, (unsigned int) value);
+    return CLI_OK;
+}
+
+CLI_Result_t mw_cmd(void)
+{
+    uint32_t arg[3];
+    uint8_t width = 4;
+    int8_t count = _parse_mem_args(arg, 3, 2, &width);
+
+    if (count < 2)
+        return CLI_ArgErr;
+
+    if (count < 3)
+        arg[2] = 1;
+
+    for (uint32_t i = 0; i < arg[2]; i++) {
+        if (!cli_mem_write((uintptr_t) arg[0] + i * width, width, arg[1]))
+            return CLI_ArgErr;
+
+        if (cli_get_int_state())
+            return CLI_WorkInt;
+    }
+
+    return CLI_OK;
+}
+#endif
+
+#if (CLI_MEM_STAT_EN == 1)
+static void _print_mem_row(const char *name, uint32_t ram, uint32_t heap, uint32_t *total)
+{
+    CLI_PRINTF("\r\n%-10s %8u %8u", name, (unsigned int) ram, (unsigned int) heap);
+    total[0] += ram;
+    total[1] += heap;
+}
+
+void cli_print_footprint(void)
+{
+    uint32_t total[2] = {0, 0};
+    uint32_t core = sizeof(CLI_State_s) - sizeof(CLI_State_s.cmds) + sizeof(output_print_buffer) +
+                    sizeof(_scratch_state);
+#if (CLI_WATCHDOG_EN == 1)
+    core += sizeof(CLI_Wd_s);
+#endif
+
+    CLI_PRINTF("\r\n%-10s %8s %8s", "RAM", "static", "heap");
+    CLI_PRINTF(SEPARATOR);
+    _print_mem_row("commands", sizeof(CLI_State_s.cmds), 0, total);
+    _print_mem_row("core", core, 0, total);
+    _print_mem_row("sessions", sizeof(_sessions), 0, total);
+    _print_mem_row("time", cli_time_get_ram_size(), 0, total);
+#if (CLI_ARENA_EN == 1)
+    _print_mem_row("arena", cli_arena_get_ram_size(), 0, total);
+#endif
+#if (DEBUG == 1) && (CLI_LOG_RATE_LIMIT_EN == 1)
+    _print_mem_row("log_rl", cli_log_rl_get_ram_size(), 0, total);
+#endif
+#if (CLI_SCHED_EN == 1)
+    _print_mem_row("sched", cli_sched_get_ram_size(), 0, total);
+#endif
+#if (CLI_SCRIPT_EN == 1)
+    _print_mem_row("script", cli_script_get_ram_size(), 0, total);
+#endif
+#if (CLI_VM_EN == 1)
+    _print_mem_row("vm", cli_vm_get_ram_size(), 0, total);
+#endif
+#if (CLI_MEM_EN == 1)
+    _print_mem_row("mem", cli_mem_get_ram_size(), 0, total);
+#endif
+#if (CLI_RPC_EN == 1)
+    _print_mem_row("rpc", cli_rpc_get_ram_size(), 0, total);
+#endif
+#if (CLI_MACHINE_EN == 1)
+    _print_mem_row("machine", cli_machine_get_ram_size(), 0, total);
+#endif
+#if (CLI_REC_EN == 1)
+    _print_mem_row("rec", cli_rec_get_ram_size(), 0, total);
+#endif
+    CLI_PRINTF(SEPARATOR);
+    CLI_PRINTF("\r\n%-10s %8u %8u", "total", (unsigned int) total[0], (unsigned int) total[1]);
+}
+
+CLI_Result_t mem_cmd(void)
+{
+#if (CLI_STACK_PAINT_EN == 1)
+    if (cli_is_arg_flag("stack")) {
+        if (cli_is_arg_flag("on"))
+            cli_mem_stack_arm(true);
+        else if (cli_is_arg_flag("off"))
+            cli_mem_stack_arm(false);
+        else
+            return CLI_ArgErr;
+
+        return CLI_OK;
+    }
+#endif
+
+    cli_print_footprint();
+
+#if (CLI_ARENA_EN == 1)
+    CLI_PRINTF("\r\n\r\narena max %u of %u", (unsigned int) cli_arena_get_high_water(), (unsigned int) CLI_ARENA_SIZE);
+#endif
+#if (CLI_STACK_PAINT_EN == 1)
+    CLI_PRINTF("\r\n\r\n%-10s %8s%s", "stack", "max", cli_mem_stack_is_armed() ? "" : "   (not sampled, mem stack on)");
+    CLI_PRINTF(SEPARATOR);
+    for (uint16_t i = 0; i < CLI_State_s.countCommand; i++) {
+        CLI_Cmd_t *cmd = &CLI_State_s.cmds[i];
+
+        if (cmd->stackMax == 0)
+            continue;
+
+        // "+" - painted region exhausted, real use is bigger
+        CLI_PRINTF("\r\n%-10s %8u%s", cmd->name, (unsigned int) cmd->stackMax, (cmd->stackMax >= CLI_STACK_PAINT_SIZE) ? "+" : "");
+    }
+#endif
+
+    return CLI_OK;
+}
+#endif
+
+#if (CLI_MACHINE_EN == 1)
+CLI_Result_t machine_cmd(void)
+{
+    char *mode = cli_get_arg(0);
+
+    if (_strcmp(mode, "on"))
+        return cli_machine_set(true) ? CLI_OK : CLI_ExecErr;
+    if (_strcmp(mode, "off"))
+        return cli_machine_set(false) ? CLI_OK : CLI_ExecErr;
+
+    return CLI_ArgErr;
+}
+#endif
+
+#if (CLI_ULOG_EN == 1)
 __attribute__((unused))
 CLI_Result_t set_loglevel(void)
 {
@@ -630,6 +1788,7 @@ CLI_Result_t set_loglevel(void)
 
     return CLI_OK;
 }
+#endif
 
 // ************************************************************************
 
@@ -653,7 +1812,7 @@ void _cli_print_time()
 
 void cli_set_first_in_cli(bool set)
 {
-    CLI_State_s.first_in = set;
+    CLI_State_s.session->first_in = set;
 }
 
 void _clear_screen(void)
@@ -669,21 +1828,47 @@ CLI_Append_Result_t cli_append_char(char ch)
     if ( rstUnlock )
         rstUnlock = false;
 
+#if (CLI_REC_EN == 1)
+    if (CLI_State_s.session == CONSOLE)
+        cli_rec_put(ch);
+#endif
+
+#if (CLI_RPC_EN == 1)
+    if (cli_rpc_is_active())
+        return cli_rpc_put_byte((uint8_t) ch) ? CLI_APPEND_Enter : CLI_APPEND_OK;
+#endif
+#if (CLI_MACHINE_EN == 1)
+    if (cli_machine_is_active()) {
+        if (ch == CHAR_INTERRUPT) {
+            _interrupt_operation = true;
+            return CLI_APPEND_OK;
+        }
+        return cli_machine_put_char(ch) ? CLI_APPEND_Enter : CLI_APPEND_OK;
+    }
+#endif
+
     CLI_InputValue_t iv = cli_input_put_char(ch);
     char c = iv.keyCode;
 
+#if (CLI_RPC_EN == 1)
+    if (cli_rpc_match_enter(ch) && cli_rpc_start()) {
+        cli_input_reset();
+        return CLI_APPEND_OK;
+    }
+#endif
+
     if ( iv.isValid ) {
         switch (c) {
             case CLI_KEY_ENTER: {
-                if (CLI_State_s.first_in == false ) {
+                if (CLI_State_s.session->first_in == false ) {
                     cli_welcome();
-                    CLI_State_s.first_in = true;
+                    CLI_State_s.session->first_in = true;
                 }
                 if ( cli_input_is_empty()) {
                     PRINT_ARROW();
                     return CLI_APPEND_Ignore;
                 }
-                CLI_State_s.isEntered = true;
+                CLI_State_s.session->isEntered = true;
 
                 cli_input_cache();
 
@@ -707,15 +1892,19 @@ CLI_Append_Result_t cli_append_char(char ch)
                 break;
 
             case CLI_KEY_TAB: {
-                if ((!cli_input_is_empty()) && (cli_input_get_last_char() != ' ')) {
-                    char *buf = cli_input_get_buffer(MainBuffer);
+                char *buf = cli_input_get_buffer(MainBuffer);
+
+                // complete command name only with cursor at end of line
+                if ((!cli_input_is_empty()) && (cli_input_get_last_char() != ' ') && (cli_input_get_cursor() == _strlen(buf))) {
                     CLI_Cmd_t *cmd = _find_part_term_cmd(buf);
 
                     if ( cmd != NULL) {
+                        // refresh from transit buffer erases tail of longer line
+                        char *completed = cli_input_get_buffer(TransitBuffer);
                         uint8_t len = _strlen(cmd->name);
 
-                        cli_input_set_buffer(MainBuffer, (char *) cmd->name, len + 1);
-                        cli_input_refresh(strcat(buf, " ")); // todo: need implement light strcat func
+                        _strcpy(cmd->name, 0, completed, 0, len + 1);
+                        cli_input_refresh(_strcat(completed, " "));
                     }
                 }
             }
@@ -772,9 +1961,3 @@ CLI_Append_Result_t cli_append_char(char ch)
 
     return CLI_APPEND_OK;
 }
-
-
-void SysTick_CLI(void)
-{
-    _tick++;
-}
\ No newline at end of file
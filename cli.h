@@ -38,6 +38,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <tinystring.h>
+#include "cli_descr.h"
+#include "cli_arena.h"
 
 
 /** @brief CLI Result Execute */
@@ -47,7 +49,8 @@ typedef enum{
 	CLI_NotFound,
 	CLI_ArgErr,
 	CLI_ExecErr,
-	CLI_WorkInt
+	CLI_WorkInt,
+	CLI_Continue                        // command not finished, call again on next cli_loop_service
 } CLI_Result_t;
 
 /** @brief CLI add new command result */
@@ -78,8 +81,70 @@ typedef enum{
 } CLI_Type_Mode_Cmd_t;
 
 
-bool cli_get_int_state(void); // todo: need implement - abort run current job
-#define CLI_CHECK_ABORT()   { if (cli_get_int_state()){return TE_WorkInt;}}
+/** @brief Check and clear Ctrl+C request (abort run current job) */
+bool cli_get_int_state(void);
+#define CLI_CHECK_ABORT()   { if (cli_get_int_state()){return CLI_WorkInt;}}
+
+/** @brief Get state buffer of current command (CLI_JOB_STATE_SIZE bytes, 8 aligned), zero on first step */
+void* cli_get_job_state(void);
+
+/** @brief Get step of current command, 0 - first call, next calls after return CLI_Continue */
+uint16_t cli_get_job_step(void);
+
+/*
+ * Temporary buffers of current command: cli_arena_alloc(size), memory is released
+ * when command returns (cli_arena.h).
+ */
+
+/**
+ * Sessions: every transport has own line editor, history, arguments and
+ * foreground command, cli_loop_service serves all sessions in turn. Session 0
+ * is the console of cli_port. Output of commands goes to the session being
+ * served, output of periodic jobs and programs goes to the console.
+ */
+
+/** @brief Transport of session */
+typedef struct {
+    void (*write)(void* ctx, const char* data, size_t len);     // output
+    size_t (*read)(void* ctx, char* buf, size_t size);          // input without blocking, NULL - cli_session_append_char
+} CLI_Transport_t;
+
+typedef struct CLI_Session CLI_Session_t;
+
+/**
+ * @brief Open session
+ * @param transport - transport, must live until cli_session_close
+ * @param ctx - context of transport
+ * @return session, NULL - CLI_SESSION_MAX sessions opened
+ * */
+CLI_Session_t* cli_session_open(const CLI_Transport_t* transport, void* ctx);
+
+/** @brief Close session, console is never closed */
+void cli_session_close(CLI_Session_t* s);
+
+/** @brief Append char to input of session (transport without read) */
+CLI_Append_Result_t cli_session_append_char(CLI_Session_t* s, char ch);
+
+/** @brief Session of current input or execute command */
+CLI_Session_t* cli_session_get_current(void);
+
+/** @brief Console session (session 0, cli_port) */
+CLI_Session_t* cli_session_get_console(void);
+
+/** @brief Output of current session (CLI_PrintChar, CLI_PrintStr) */
+void cli_session_write(const char* data, size_t len);
+
+/** @brief Output to transport of current session, bypass of cli_session_set_write */
+void cli_session_send(const char* data, size_t len);
+
+/** @brief Redirect output of current session, NULL - transport */
+void cli_session_set_write(void (*write)(const char* data, size_t len));
+
+/** @brief Name of command by index in order of cli_add_new_cmd, NULL - no command */
+const char* cli_get_cmd_name(uint16_t index);
+
+/** @brief Count of commands */
+uint16_t cli_get_cmd_count(void);
 
 /** @brief Terminal initialize */
 void cli_init(void);
@@ -87,6 +152,22 @@ void cli_init(void);
 /** @brief CLI loop Execute input command */
 bool cli_loop_service(void);
 
+/**
+ * @brief Execute command string without prompt and result print
+ * @param str - command string include arguments
+ * @return result execute command
+ * */
+CLI_Result_t cli_execute(const char* str);
+
+/**
+ * @brief Execute one step of resumable command
+ * @param str - command string include arguments
+ * @param state - state buffer of command, CLI_JOB_STATE_SIZE bytes
+ * @param step - step number
+ * @return result execute command, CLI_Continue - command not finished
+ * */
+CLI_Result_t cli_execute_step(const char* str, void* state, uint16_t step);
+
 
 /**
  * @brief Function for Add command
@@ -94,13 +175,31 @@ bool cli_loop_service(void);
  * @param fcn - callback function
  * @param argc - min count arguments
  * @param mode - execute mode
- * @param descr - description
+ * @param descr - description, CLI_DESCR(ID, text) for compressed or stripped descriptions
  * @return result append command
  * */
 CLI_Add_Result_t cli_add_new_cmd(const char* name, CLI_Result_t (*fcn)(), uint8_t argc, CLI_Type_Mode_Cmd_t mode, const char* descr);
 
+/**
+ * @brief Set deadline of command, for resumable command - deadline of one step
+ * @param name - command name
+ * @param deadlineMs - max execute time in ms, 0 - no deadline
+ * @return false if command not found
+ * */
+bool cli_set_cmd_deadline(const char* name, uint32_t deadlineMs);
+
+/**
+ * @brief Set escalation hook, called from SysTick_CLI when command ignored abort
+ *        CLI_WATCHDOG_GRACE_MS after deadline (reset MCU, log, etc.)
+ * @param hook - callback with command name, NULL - only abort flag
+ * */
+void cli_set_watchdog_hook(void (*hook)(const char* name));
+
+/** @brief Check deadline of execute command, call from SysTick_CLI */
+void cli_watchdog_tick(void);
 
-/** @brief Append new symbols for cli input parser */
+
+/** @brief Append new symbols for cli input parser of current session, from RX interrupt use CLI_AppendChar */
 CLI_Append_Result_t cli_append_char(char ch);
 
 /** @brief This function for check arguments flag */
@@ -131,6 +230,9 @@ uint32_t cli_get_arg_hex(uint8_t index);
 
 void cli_set_first_in_cli(bool set);
 
+/** @brief Print static and heap bytes of CLI subsystems ("mem" command), valid before cli_init */
+void cli_print_footprint(void);
+
 void SysTick_CLI(void); // todo: need refactor name
 
 #endif // _CLI_H_
@@ -0,0 +1,395 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#ifndef _CLI_HPP_
+#define _CLI_HPP_
+
+/*
+ * Optional C++17 front-end for CLI_PRINTF.
+ *
+ * The format string is parsed at compile time, every argument is checked against
+ * its conversion and the call is expanded into a fixed sequence of tinyprintf
+ * kernel calls, so nothing is parsed at run time and a mismatch is a build error:
+ *
+ *   CLI_PRINTF_CT("%-8s %5u %08X\r\n", name, count, reg);
+ *   cli::format(buf, sizeof(buf), CLI_FMT("%q16.16"), raw);
+ *
+ * Supported: flags, width, precision, d i u x X o b c s p f F q and %%.
+ * '*' width/precision and e/E/g/G are rejected. Length modifiers h and hh truncate
+ * as in C, the others are accepted and ignored: the value always is taken with
+ * the real type of the argument.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>           // before tinyprintf.h renames the stdio functions
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "cli.h"
+#include "tinyprintf.h"
+}
+
+namespace cli {
+namespace detail {
+
+enum class Conv : uint8_t { Lit, Int, Char, Str, Ptr, Fixed, Float };
+
+struct Spec {
+    Conv conv;
+    char length;            // 0, 'h' - short, 'H' - char, other modifiers are not stored
+    bool sign;              // d, i
+    unsigned int flags;     // PRINTF_FLAG_xxx after the same adjustment as _vsnprintf
+    unsigned int width;
+    unsigned int prec;
+    unsigned int base;
+    unsigned int fbits;     // %q fraction bits
+    std::size_t arg;        // argument index
+    std::size_t off;        // Lit: offset in the format string
+    std::size_t len;        // Lit: length
+};
+
+template <std::size_t N>
+struct Parsed {
+    Spec spec[N];
+    std::size_t count;      // number of emit steps
+    std::size_t args;       // number of arguments consumed
+    bool ok;
+};
+
+constexpr bool _is_digit(char c) { return (c >= '0') && (c <= '9'); }
+
+constexpr unsigned int _atoi(std::string_view f, std::size_t& i)
+{
+    unsigned int v = 0U;
+    while ((i < f.size()) && _is_digit(f[i])) {
+        v = v * 10U + (unsigned int)(f[i++] - '0');
+    }
+    return v;
+}
+
+// upper bound of emit steps: every '%' can close a literal and open a conversion
+constexpr std::size_t _capacity(std::string_view f)
+{
+    std::size_t n = 1U;
+    for (char c : f) {
+        if (c == '%') {
+            n += 2U;
+        }
+    }
+    return n;
+}
+
+template <std::size_t N>
+constexpr Parsed<N> parse(std::string_view f)
+{
+    Parsed<N> r{};
+    std::size_t i = 0U;
+    r.ok = true;
+
+    while (r.ok && (i < f.size())) {
+        Spec s{};
+        if (f[i] != '%') {
+            // literal run up to the next specifier
+            s.conv = Conv::Lit;
+            s.off = i;
+            while ((i < f.size()) && (f[i] != '%')) {
+                i++;
+            }
+            s.len = i - s.off;
+            r.spec[r.count++] = s;
+            continue;
+        }
+        i++;
+
+        // flags
+        for (bool more = true; more && (i < f.size()); ) {
+            switch (f[i]) {
+                case '0': s.flags |= PRINTF_FLAG_ZEROPAD; i++; break;
+                case '-': s.flags |= PRINTF_FLAG_LEFT;    i++; break;
+                case '+': s.flags |= PRINTF_FLAG_PLUS;    i++; break;
+                case ' ': s.flags |= PRINTF_FLAG_SPACE;   i++; break;
+                case '#': s.flags |= PRINTF_FLAG_HASH;    i++; break;
+                default : more = false;                        break;
+            }
+        }
+
+        // width and precision, '*' needs a run-time argument
+        s.width = _atoi(f, i);
+        if ((i < f.size()) && (f[i] == '.')) {
+            s.flags |= PRINTF_FLAG_PRECISION;
+            i++;
+            s.prec = _atoi(f, i);
+        }
+        if ((i < f.size()) && (f[i] == '*')) {
+            r.ok = false;
+            break;
+        }
+
+        // length
+        if (i < f.size()) {
+            switch (f[i]) {
+                case 'l':
+                    i++;
+                    if ((i < f.size()) && (f[i] == 'l')) i++;
+                    break;
+                case 'h':
+                    s.length = 'h';
+                    i++;
+                    if ((i < f.size()) && (f[i] == 'h')) {
+                        s.length = 'H';
+                        i++;
+                    }
+                    break;
+                case 't':
+                case 'j':
+                case 'z':
+                    i++;
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (i >= f.size()) {
+            r.ok = false;
+            break;
+        }
+
+        // specifier
+        const char c = f[i++];
+        switch (c) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'b':
+                s.conv = Conv::Int;
+                s.sign = (c == 'd') || (c == 'i');
+                s.base = ((c == 'x') || (c == 'X')) ? 16U : (c == 'o') ? 8U : (c == 'b') ? 2U : 10U;
+                if (s.base == 10U) {
+                    s.flags &= ~PRINTF_FLAG_HASH;
+                }
+                if (c == 'X') {
+                    s.flags |= PRINTF_FLAG_UPPERCASE;
+                }
+                if (!s.sign) {
+                    s.flags &= ~(PRINTF_FLAG_PLUS | PRINTF_FLAG_SPACE);
+                }
+                if (s.flags & PRINTF_FLAG_PRECISION) {
+                    s.flags &= ~PRINTF_FLAG_ZEROPAD;
+                }
+                break;
+            case 'q': {
+                s.conv = Conv::Fixed;
+                s.fbits = _atoi(f, i);
+                if ((i < f.size()) && (f[i] == '.')) {
+                    i++;
+                    s.fbits = _atoi(f, i);
+                }
+                if (s.fbits > 32U) {
+                    s.fbits = 32U;
+                }
+                break;
+            }
+            case 'f': case 'F':
+                s.conv = Conv::Float;
+                if (c == 'F') {
+                    s.flags |= PRINTF_FLAG_UPPERCASE;
+                }
+                break;
+            case 'c':
+                s.conv = Conv::Char;
+                break;
+            case 's':
+                s.conv = Conv::Str;
+                break;
+            case 'p':
+                s.conv = Conv::Ptr;
+                s.base = 16U;
+                s.width = sizeof(void*) * 2U;
+                s.flags |= PRINTF_FLAG_ZEROPAD | PRINTF_FLAG_UPPERCASE;
+                break;
+            case '%': {
+                // '%' opens the next literal run
+                s.conv = Conv::Lit;
+                s.off = i - 1U;
+                while ((i < f.size()) && (f[i] != '%')) {
+                    i++;
+                }
+                s.len = i - s.off;
+                r.spec[r.count++] = s;
+                continue;
+            }
+            default:
+                r.ok = false;
+                continue;
+        }
+        s.arg = r.args++;
+        r.spec[r.count++] = s;
+    }
+    return r;
+}
+
+template <class Fmt>
+inline constexpr auto parsed_v = parse<_capacity(Fmt::value())>(Fmt::value());
+
+template <class T>
+using bare_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <class T>
+constexpr bool is_str_v = std::is_same_v<std::decay_t<bare_t<T>>, char*> ||
+                          std::is_same_v<std::decay_t<bare_t<T>>, const char*> ||
+                          std::is_same_v<bare_t<T>, std::string_view>;
+
+template <Conv C, class T>
+constexpr bool accepts_v =
+    ((C == Conv::Int) || (C == Conv::Char) || (C == Conv::Fixed)) ? std::is_integral_v<bare_t<T>> :
+    (C == Conv::Str)   ? is_str_v<T> :
+    (C == Conv::Ptr)   ? (std::is_pointer_v<std::decay_t<bare_t<T>>> || std::is_null_pointer_v<bare_t<T>>) :
+    (C == Conv::Float) ? std::is_floating_point_v<bare_t<T>> : false;
+
+// integer value as the C call would see it after default promotion and h/hh
+template <class T, char Length>
+constexpr long long to_signed(T v)
+{
+    using P = std::make_signed_t<decltype(+v)>;
+    return (Length == 'H') ? (long long)(signed char)v : (Length == 'h') ? (long long)(short)v : (long long)(P)v;
+}
+
+template <class T, char Length>
+constexpr unsigned long long to_unsigned(T v)
+{
+    using P = std::make_unsigned_t<decltype(+v)>;
+    return (Length == 'H') ? (unsigned char)v : (Length == 'h') ? (unsigned short)v : (unsigned long long)(P)v;
+}
+
+template <class Fmt, std::size_t K, class Tuple>
+inline std::size_t emit_one(char* buffer, std::size_t idx, std::size_t maxlen, const Tuple& args)
+{
+    constexpr Spec s = parsed_v<Fmt>.spec[K];
+
+    if constexpr (s.conv == Conv::Lit) {
+        return tinyprintf_str(buffer, idx, maxlen, Fmt::value().data() + s.off, s.len, 0U, 0U);
+    }
+    else {
+        const auto& a = std::get<s.arg>(args);
+        using T = bare_t<decltype(a)>;
+        static_assert(accepts_v<s.conv, T>, "cli: argument type does not match the conversion in the format string");
+
+        if constexpr (!accepts_v<s.conv, T>) {
+            return idx;
+        }
+        else if constexpr (s.conv == Conv::Int) {
+            if constexpr (s.sign) {
+                const long long v = to_signed<T, s.length>(a);
+                return tinyprintf_ntoa(buffer, idx, maxlen, (v > 0 ? (unsigned long long)v : 0ULL - (unsigned long long)v), v < 0, s.base, s.prec, s.width, s.flags);
+            }
+            else {
+                return tinyprintf_ntoa(buffer, idx, maxlen, to_unsigned<T, s.length>(a), 0, s.base, s.prec, s.width, s.flags);
+            }
+        }
+        else if constexpr (s.conv == Conv::Fixed) {
+            return tinyprintf_qtoa(buffer, idx, maxlen, to_signed<T, s.length>(a), s.fbits, s.prec, s.width, s.flags);
+        }
+        else if constexpr (s.conv == Conv::Float) {
+            return tinyprintf_ftoa(buffer, idx, maxlen, (double)a, s.prec, s.width, s.flags);
+        }
+        else if constexpr (s.conv == Conv::Char) {
+            const char c = (char)a;
+            return tinyprintf_str(buffer, idx, maxlen, &c, 1U, s.width, s.flags);
+        }
+        else if constexpr (s.conv == Conv::Ptr) {
+            return tinyprintf_ntoa(buffer, idx, maxlen, (uintptr_t)a, 0, 16U, s.prec, s.width, s.flags);
+        }
+        else {
+            std::size_t l = 0U;
+            const char* p;
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                p = a.data();
+                l = a.size();
+                if ((s.flags & PRINTF_FLAG_PRECISION) && (l > s.prec)) {
+                    l = s.prec;
+                }
+            }
+            else {
+                p = a;
+                const std::size_t lim = (s.flags & PRINTF_FLAG_PRECISION) ? s.prec : (std::size_t)-1;
+                while ((l < lim) && p[l]) {
+                    l++;
+                }
+            }
+            return tinyprintf_str(buffer, idx, maxlen, p, l, s.width, s.flags);
+        }
+    }
+}
+
+template <class Fmt, class Tuple, std::size_t... K>
+inline std::size_t emit(char* buffer, std::size_t maxlen, const Tuple& args, std::index_sequence<K...>)
+{
+    std::size_t idx = 0U;
+    (void)buffer; (void)maxlen; (void)args;
+    ((idx = emit_one<Fmt, K>(buffer, idx, maxlen, args)), ...);
+    return idx;
+}
+
+} // namespace detail
+
+
+/**
+ * @brief snprintf_ with the format parsed at compile time, fmt is CLI_FMT("...")
+ * @return number of chars the full output needs, without terminating \0
+ */
+template <class Fmt, class... Args>
+inline int format(char* buffer, std::size_t count, Fmt, const Args&... args)
+{
+    constexpr auto& p = detail::parsed_v<Fmt>;
+    static_assert(p.ok, "cli: invalid or unsupported format string");
+    static_assert(!p.ok || (p.args == sizeof...(Args)), "cli: argument count does not match the format string");
+
+    std::size_t idx = 0U;
+    if constexpr (p.ok && (p.args == sizeof...(Args))) {
+        idx = detail::emit<Fmt>(buffer, count, std::forward_as_tuple(args...), std::make_index_sequence<p.count>{});
+    }
+    if (count) {
+        buffer[idx < count ? idx : count - 1U] = '\0';
+    }
+    return (int)idx;
+}
+
+
+/**
+ * @brief CLI_PRINTF with the format parsed at compile time
+ */
+template <class Fmt, class... Args>
+inline void print(Fmt fmt, const Args&... args)
+{
+    format(output_print_buffer, sizeof(output_print_buffer), fmt, args...);
+    CLI_PrintStr(output_print_buffer);
+}
+
+} // namespace cli
+
+
+// wrap a string literal into a type, each use site gets its own specialisation
+#define CLI_FMT(s_)                             ([]{ struct _cli_fmt { static constexpr std::string_view value() { return (s_); } }; return _cli_fmt{}; }())
+#define CLI_PRINTF_CT(f_, ...)                  cli::print(CLI_FMT(f_), ##__VA_ARGS__)
+
+#endif // _CLI_HPP_
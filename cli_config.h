@@ -68,6 +68,9 @@
 // **************************************************************************
 
 // **********************    CLI Settings   *********************************
+#ifndef CLI_PORT_HOST
+#define CLI_PORT_HOST                           (0)                 // POSIX host port (port/posix), CMake build defines 1
+#endif
 #ifndef BUILD_NAME
 #define BUILD_NAME                              ("______________")  // If not defined before build -DBUILD_NAME, will be defined here
 #endif
@@ -94,11 +97,14 @@
 #endif
 
 #define _TERM_VER_                              ("v0.0.2")          // CLI version
+#ifndef CLI_SIZE_MAX_CMD
 #define CLI_SIZE_MAX_CMD                        (20)                // Max number of commands
-#define CLI_CMD_BUF_SIZE                        (20)                // Max number of character buffer string command
+#endif
+#define CLI_CMD_BUF_SIZE                        (32)                // Max number of character buffer string command
 #define CLI_CMD_LOG_SIZE                        (10)                // Max number of loging command
 #define CLI_ARGS_BUF_SIZE                       (10)                // Max number of arguments in one command
 #define CLI_ARG_SIZE                            (5)                 // Max number character of one arguments
+#define CLI_JOB_STATE_SIZE                      (16)                // Size of state buffer for resumable command (CLI_Continue)
 #define CHAR_INTERRUPT                          (0x03)              // Abort execute command key-code symbol
 #define STRING_TERM_ENTER                       ("\n\r")            // String new line
 #define STRING_TERM_ARROW                       (">> ")             // String arrow enter
@@ -107,11 +113,83 @@
 #define CLI_DEFAULT_ALLOC_EN                    (1)                 // Default Memory Allocate functions (use static or malloc memmory for add new command)
 #define CLI_DEFAULT_STRING_EN                   (1)                 // Default String functions
 #define CLI_TINY_SPRINTF                        (1)                 // Default sprintf functions
+#ifndef CLI_DESCR_MODE
+#define CLI_DESCR_MODE                          (0)                 // Descriptions of CLI_DESCR: 0 - plain, 1 - compressed (tools/cli_descr_gen.py), 2 - stripped
+#endif
 #define CLI_PRINT_ERROR_EXEC_EN                 (1)                 // Print error after execute command
 #define CLI_PRINT_ERROR_ADD_CMD_EN              (1)                 // Print error after added command
+// Subsystems below marked (CLI_PORT_HOST) are off in firmware by default, enable them with -D<NAME>=1
+#ifndef CLI_CMD_STATS_EN
+#define CLI_CMD_STATS_EN                        (CLI_PORT_HOST)     // Execute statistics for every command, "stats" command
+#endif
+#define CLI_STATS_HIST_SIZE                     (16)                // Number of log2 buckets of execute time histogram
+#define CLI_STATS_HIST_SHIFT                    (6)                 // First bucket of histogram: execute time < 2^SHIFT
+#ifndef CLI_WATCHDOG_EN
+#define CLI_WATCHDOG_EN                         (CLI_PORT_HOST)     // Deadline of command execute, checked from SysTick_CLI
+#endif
+#define CLI_DEFAULT_DEADLINE_MS                 (0)                 // Deadline of new command in ms (0 - no deadline)
+#define CLI_WATCHDOG_GRACE_MS                   (100)               // Time after abort flag before escalation hook in ms
+#ifndef CLI_SCHED_EN
+#define CLI_SCHED_EN                            (CLI_PORT_HOST)     // Command scheduler, "every", "repeat", "jobs", "kill" commands and "<cmd> &"
+#endif
+#define CLI_SCHED_MAX_JOBS                      (4)                 // Max number of scheduled and background jobs
+#define CLI_SCHED_WHEEL_SIZE                    (16)                // Number of timer wheel slots, 1 ms per slot (power of 2)
+#define CLI_SCRIPT_EN                           (1)                 // Command chaining ';', "&&", "||" and "run" command
+#define CLI_SCRIPT_MAX                          (4)                 // Max number of registered scripts for "run"
+#define CLI_SCRIPT_DEPTH_MAX                    (4)                 // Max depth of nested "run" in scripts
+#define CLI_SCRIPT_SPIN_MAX                     (1000)              // Max steps of resumable command in blocking script (nested "run", jobs)
+#define CLI_SCRIPT_FILE_EN                      (CLI_PORT_HOST)     // "run <file>" reads script from file (host port)
+#ifndef CLI_VM_EN
+#define CLI_VM_EN                               (CLI_PORT_HOST)     // Bytecode scripting engine, "vm" command
+#endif
+#define CLI_VM_CODE_SIZE                        (256)               // Size of bytecode memory for all programs
+#define CLI_VM_MAX_PROGS                        (4)                 // Max number of compiled programs
+#define CLI_VM_MAX_VARS                         (10)                // Max number of variables in program include "rc", "ret"
+#define CLI_VM_NAME_SIZE                        (8)                 // Max number character of variable name
+#define CLI_VM_STACK_SIZE                       (8)                 // Depth of expression stack
+#define CLI_VM_MAX_DEPTH                        (4)                 // Max number of nested if/while/for blocks
+#define CLI_VM_MAX_RUN                          (1)                 // Max number of programs running at the same time
+#define CLI_VM_BUDGET                           (32)                // Max number of instructions per cli_loop_service
+#ifndef CLI_MEM_EN
+#define CLI_MEM_EN                              (CLI_PORT_HOST)     // Memory commands "md", "mr", "mw"
+#endif
+#define CLI_MEM_DUMP_DEFAULT                    (64)                // Default number of bytes for "md"
+#define CLI_MEM_SIM_EN                          (CLI_PORT_HOST)     // Memory commands access simulated region (host port)
+#define CLI_MEM_SIM_BASE                        (0x20000000UL)      // Address of simulated region
+#define CLI_MEM_SIM_SIZE                        (4096)              // Size of simulated region
+#ifndef CLI_MEM_STAT_EN
+#define CLI_MEM_STAT_EN                         (CLI_PORT_HOST)     // "mem" command: static and heap bytes per subsystem, stack high-water per command
+#endif
+#define CLI_STACK_PAINT_EN                      (CLI_MEM_STAT_EN)   // Stack high-water of commands by stack painting, sampled after "mem stack on"
+#define CLI_STACK_PAINT_SIZE                    (CLI_PORT_HOST ? 8192 : 1024)   // Painted bytes of stack below execute frame, must fit in free stack
+#ifndef CLI_ARENA_EN
+#define CLI_ARENA_EN                            (CLI_PORT_HOST)     // Scratch arena of commands, released after every command
+#endif
+#define CLI_ARENA_SIZE                          (256)               // Size of scratch arena in bytes
+#ifndef CLI_RPC_EN
+#define CLI_RPC_EN                              (CLI_PORT_HOST)     // Binary RPC mode over command table, entered by CLI_RPC_ENTER_SEQ
+#endif
+#define CLI_RPC_FRAME_SIZE                      (128)               // Max size of decoded frame (response: output of command)
+#ifndef CLI_MACHINE_EN
+#define CLI_MACHINE_EN                          (CLI_PORT_HOST)     // Machine text mode: "machine on|off", no echo and prompt, "#tag status output" replies
+#endif
+#define CLI_MACHINE_QUEUE_SIZE                  (4)                 // Max number of received request lines waiting for execute
+#define CLI_MACHINE_REPLY_SIZE                  (128)               // Max number of chars of reply output
+#define CLI_MACHINE_TAG_SIZE                    (8)                 // Max number of chars of request tag
+#define CLI_SESSION_MAX                         (CLI_PORT_HOST ? 32 : 1)    // Max number of sessions (transports), 0 - console of cli_port
+#define CLI_SESSION_READ_SIZE                   (64)                // Max number of chars of one transport read per loop
+#define CLI_REC_EN                              (CLI_PORT_HOST)     // Recorder of input chars with tick timestamps, "cli_host --record"
+#define CLI_REC_RUN_SIZE                        (32)                // Max number of chars of one tick in one record run
+#define CLI_ULOG_EN                             (!CLI_PORT_HOST)    // External ulog logger, "loglevel" command
 #define ECHO_EN                                 (1)                 // Enter echo enable
 #define DEBUG                                   (1)                 // For debug
 #define DEBUG_TIMESTAMP                         (1)                 // Included timestamp for debug messages
+#define CLI_LOG_RATE_LIMIT_EN                   (1)                 // Suppress repeated debug messages of one call site
+#define CLI_LOG_RL_SLOTS                        (8)                 // Max number of tracked call sites (power of 2)
+#define CLI_LOG_RL_WINDOW_MS                    (1000)              // Suppress window in ms
+#define CLI_LOG_RL_DEBUG_MAX                    (5)                 // Max number of LOG_DEBUG of one call site in window (0 - no limit)
+#define CLI_LOG_RL_INFO_MAX                     (5)                 // Max number of LOG_INFO of one call site in window (0 - no limit)
+#define CLI_LOG_RL_ERROR_MAX                    (10)                // Max number of LOG_ERROR of one call site in window (0 - no limit)
 
 // **************************************************************************
 
@@ -137,14 +215,20 @@ extern char output_print_buffer[256];
 
 /**< This macro for debug software */
 #if (DEBUG == 1) // todo: need implement LOG LEVEL : 3 - Debug, 2 - Info, 1 - Error, 0 - Nothing print in console
+#if (CLI_LOG_RATE_LIMIT_EN == 1)
+#include "cli_log_rl.h"
+#define _LOG_FILTER(lvl_, f_)                   if (cli_log_rl_check(lvl_, f_, __LINE__))
+#else
+#define _LOG_FILTER(lvl_, f_)
+#endif
 #if (DEBUG_TIMESTAMP == 1)
-#define LOG_DEBUG(f_, ...)                      CLI_PRINTF(("%s [DEBUG] "f_), cli_time_get_curr_time_str(), ##__VA_ARGS__)
-#define LOG_INFO(f_, ...)                       CLI_PRINTF(("%s [INFO] "f_), cli_time_get_curr_time_str(), ##__VA_ARGS__)
-#define LOG_ERROR(f_, ...)                      CLI_PRINTF(("%s [ERROR] "f_), cli_time_get_curr_time_str(), ##__VA_ARGS__)
+#define LOG_DEBUG(f_, ...)                      {_LOG_FILTER(CLI_LOG_LEVEL_DEBUG, f_) CLI_PRINTF(("%s [DEBUG] "f_), cli_time_get_curr_time_str(), ##__VA_ARGS__)}
+#define LOG_INFO(f_, ...)                       {_LOG_FILTER(CLI_LOG_LEVEL_INFO, f_) CLI_PRINTF(("%s [INFO] "f_), cli_time_get_curr_time_str(), ##__VA_ARGS__)}
+#define LOG_ERROR(f_, ...)                      {_LOG_FILTER(CLI_LOG_LEVEL_ERROR, f_) CLI_PRINTF(("%s [ERROR] "f_), cli_time_get_curr_time_str(), ##__VA_ARGS__)}
 #else
-#define LOG_DEBUG(f_, ...)                      CLI_PRINTF(("\n[DEBUG] "f_), ##__VA_ARGS__)
-#define LOG_INFO(f_, ...)                       CLI_PRINTF(("\n[INFO] "f_), ##__VA_ARGS__)
-#define LOG_ERROR(f_, ...)                      CLI_PRINTF(("\n[ERROR] "f_), ##__VA_ARGS__)
+#define LOG_DEBUG(f_, ...)                      {_LOG_FILTER(CLI_LOG_LEVEL_DEBUG, f_) CLI_PRINTF(("\n[DEBUG] "f_), ##__VA_ARGS__)}
+#define LOG_INFO(f_, ...)                       {_LOG_FILTER(CLI_LOG_LEVEL_INFO, f_) CLI_PRINTF(("\n[INFO] "f_), ##__VA_ARGS__)}
+#define LOG_ERROR(f_, ...)                      {_LOG_FILTER(CLI_LOG_LEVEL_ERROR, f_) CLI_PRINTF(("\n[ERROR] "f_), ##__VA_ARGS__)}
 #endif
 #else
 #define LOG_DEBUG(f_, ...)
@@ -155,16 +239,18 @@ extern char output_print_buffer[256];
 
 // ************************ Time calculate Settings *************************
 
+#define CLI_TICK_FREQ_HZ                        (1000)                  // Frequency of SysTick_CLI() calls, must divide 1000000 (also used by recorder and host port)
+
 #if (CLI_TIMELEFT_EN == 1)
 
 // yout implementation
 extern volatile uint64_t _tick;
-#define CLI_GET_US()                            ((float)_tick * 1000)   // System time in us
-#define CLI_GetFastUs()                         (_tick << 3)            // System time in us (not exact)
-#define CLI_GetFastMs()                         (_tick >> 7)            // System time in ms (not exact)
-#define CLI_CounterReset()                      {_tick = 0;}
+#define CLI_GET_US()                            (cli_time_get_us())     // System time in us
+#define CLI_GetFastUs()                         ((uint32_t) _tick * (1000000 / CLI_TICK_FREQ_HZ))  // System time in us (32 bit, wraps)
+#define CLI_GetFastMs()                         (cli_time_get_ms())     // System time in ms (32 bit, wraps)
+#define CLI_CounterReset()                      {cli_time_reset();}
 #else	// CLI_TIMELEFT_EN != 1
-#define CLI_GetUs()                             (0)                     // System time in us
+#define CLI_GET_US()                            (0)                     // System time in us
 #define CLI_GetFastUs()                         (0)                     // System time in us (not exact)
 #define CLI_GetFastMs()                         (0)                     // System time in ms (not exact)
 #define CLI_CounterReset()                      {}
@@ -188,10 +274,14 @@ extern volatile uint64_t _tick;
 
 #if (CLI_DEFAULT_STRING_EN == 1)
 #include <string.h>
-#include <tinystring.h>  // todo: need implement tiny memcpy, see tiny inystring.h
 #define cli_memcpy                              memcpy
+#define cli_memset                              memset
+#define cli_memmove                             memmove
 #else
-#define cli_memcpy                                                      // your implementation
+#include <tinystring.h>
+#define cli_memcpy                              _memcpy                 // word-at-a-time copy from tinystring
+#define cli_memset                              _memset
+#define cli_memmove                             _memmove
 #endif
 
 
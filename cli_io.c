@@ -31,25 +31,28 @@
  * */
 
 #include "cli_io.h"
+#include "cli_port.h"
 
-/** Your implementation of acceptance a character with IO stream
- * just call this function and put character symbol with IO */
+/** Acceptance a character with IO stream, call from RX interrupt
+ * or loop of cli_port_read(). Goes to console whichever session
+ * cli_loop_service is serving at the moment of interrupt */
 void CLI_AppendChar(char c)
 {
-    // your implementation RX char
+    cli_session_append_char(cli_session_get_console(), c);
 }
 
-/** Your implementation of sending a character to IO stream */
+/** Sending a character to IO stream */
 void CLI_PrintChar(char c)
 {
-    // your implementation TX char
+    cli_session_write(&c, 1);
 }
 
 void CLI_PrintStr(char *str)
 {
-    uint16_t i = 0;
-    while (str[i] != '\0') {
-        CLI_PrintChar(str[i]);
-        i++;
-    }
+    cli_session_write(str, _strlen(str));
+}
+
+void CLI_SetWrite(void (*write)(const char* str, size_t len))
+{
+    cli_session_set_write(write);
 }
@@ -38,4 +38,7 @@ void CLI_AppendChar(char c);
 void CLI_PrintStr(char* str);
 void CLI_PrintChar(char c);
 
+/** @brief Redirect output of CLI_PrintChar and CLI_PrintStr of current session, NULL - transport */
+void CLI_SetWrite(void (*write)(const char* str, size_t len));
+
 #endif //_CLI_IO_H_
@@ -0,0 +1,58 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#ifndef _CLI_PORT_H_
+#define _CLI_PORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Platform layer, implemented by one port (port/<platform>/cli_port_<platform>.c):
+ *   - tick: SysTick_CLI() must be called CLI_TICK_FREQ_HZ times per second
+ *   - unique ID, reset, delay
+ *   - transport: TX of strings, RX of chars (or CLI_AppendChar from RX interrupt)
+ */
+
+/** @brief Init platform: tick source and transport, called from cli_init */
+void cli_port_init(void);
+
+/** @brief Get 96-bit unique ID of device */
+void cli_port_get_uid(uint32_t uid[3]);
+
+/** @brief Reset device */
+void cli_port_reset(void);
+
+/** @brief Blocking delay in ms */
+void cli_port_delay_ms(uint32_t ms);
+
+/** @brief Send len chars */
+void cli_port_write(const char* str, size_t len);
+
+/**
+ * @brief Receive one char without blocking
+ * @return char 0..255 or -1 if no char
+ * */
+int16_t cli_port_read(void);
+
+#endif // _CLI_PORT_H_
@@ -0,0 +1,107 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_arena.h"
+
+#if (CLI_ARENA_EN == 1)
+
+/** @brief Scratch arena */
+static struct{
+    uint8_t buf[CLI_ARENA_SIZE] __attribute__((aligned(CLI_ARENA_ALIGN)));
+    uint32_t top;                   // first free byte
+    uint32_t highWater;             // max of top
+}CLI_Arena_s;
+
+void* cli_arena_alloc(size_t size)
+{
+    size_t need = (size + CLI_ARENA_ALIGN - 1U) & ~((size_t) CLI_ARENA_ALIGN - 1U);
+
+    if ((size == 0) || (need > CLI_ARENA_SIZE - CLI_Arena_s.top))
+        return NULL;
+
+    void* ptr = &CLI_Arena_s.buf[CLI_Arena_s.top];
+    CLI_Arena_s.top += (uint32_t) need;
+    if (CLI_Arena_s.top > CLI_Arena_s.highWater)
+        CLI_Arena_s.highWater = CLI_Arena_s.top;
+
+    return ptr;
+}
+
+uint32_t cli_arena_get_free(void)
+{
+    return CLI_ARENA_SIZE - CLI_Arena_s.top;
+}
+
+uint32_t cli_arena_mark(void)
+{
+    return CLI_Arena_s.top;
+}
+
+void cli_arena_release(uint32_t mark)
+{
+    if (mark < CLI_Arena_s.top)
+        CLI_Arena_s.top = mark;
+}
+
+uint32_t cli_arena_get_high_water(void)
+{
+    return CLI_Arena_s.highWater;
+}
+
+uint32_t cli_arena_get_ram_size(void)
+{
+    return sizeof(CLI_Arena_s);
+}
+
+#else
+
+void* cli_arena_alloc(size_t size)
+{
+    (void) size;
+    return NULL;
+}
+
+uint32_t cli_arena_get_free(void)
+{
+    return 0;
+}
+
+uint32_t cli_arena_mark(void)
+{
+    return 0;
+}
+
+void cli_arena_release(uint32_t mark)
+{
+    (void) mark;
+}
+
+uint32_t cli_arena_get_high_water(void)
+{
+    return 0;
+}
+
+uint32_t cli_arena_get_ram_size(void)
+{
+    return 0;
+}
+
+#endif
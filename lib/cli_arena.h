@@ -0,0 +1,61 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_ARENA_H_
+#define _CLI_ARENA_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Scratch arena of commands: bump pointer over a static buffer of CLI_ARENA_SIZE
+ * bytes. Execute of every command takes a mark and releases memory allocated by
+ * handler (and nested commands) when handler returns, so release is O(1) and
+ * nothing is freed by handler. Memory is not kept between steps of a resumable
+ * command (CLI_Continue), state of steps lives in cli_get_job_state().
+ */
+
+#define CLI_ARENA_ALIGN         (8U)                // alignment of every allocation
+
+/**
+ * @brief Allocate scratch memory of current command
+ * @param size - bytes
+ * @return pointer aligned to CLI_ARENA_ALIGN or NULL if arena is exhausted
+ * */
+void* cli_arena_alloc(size_t size);
+
+/** @brief Free bytes of arena */
+uint32_t cli_arena_get_free(void);
+
+/** @brief Current top of arena, called before execute of command */
+uint32_t cli_arena_mark(void);
+
+/** @brief Release all memory allocated after mark, called after execute of command */
+void cli_arena_release(uint32_t mark);
+
+/** @brief Max used bytes of arena since start */
+uint32_t cli_arena_get_high_water(void);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_arena_get_ram_size(void);
+
+#endif // _CLI_ARENA_H_
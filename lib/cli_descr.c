@@ -0,0 +1,82 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#include "cli_descr.h"
+#include "cli_io.h"
+
+#if (CLI_DESCR_MODE == 1)
+
+#define DESCR_CHUNK_SIZE        (32)                        // decoded chars per CLI_PrintStr
+
+static const char _dict[] = CLI_DESCR_DICT;
+
+/** @brief Find word of dictionary, words are packed as length + chars */
+static const char* _dict_word(uint8_t index, uint8_t* len)
+{
+    const char* w = _dict;
+
+    while (index-- != 0)
+        w += 1 + (uint8_t) w[0];
+
+    *len = (uint8_t) w[0];
+    return w + 1;
+}
+
+static void _print_compressed(const char* descr)
+{
+    char chunk[DESCR_CHUNK_SIZE + 1];
+    uint8_t count = 0;
+
+    for (const uint8_t* p = (const uint8_t*) descr + 1; *p != '\0'; p++) {
+        const char* word = (const char*) p;
+        uint8_t len = 1;
+
+        if ((*p & 0x80) != 0)
+            word = _dict_word(*p & 0x7F, &len);
+
+        for (uint8_t i = 0; i < len; i++) {
+            if (count == DESCR_CHUNK_SIZE) {
+                chunk[count] = '\0';
+                CLI_PrintStr(chunk);
+                count = 0;
+            }
+            chunk[count++] = word[i];
+        }
+    }
+
+    chunk[count] = '\0';
+    CLI_PrintStr(chunk);
+}
+#endif
+
+void cli_descr_print(const char* descr)
+{
+    if (descr == NULL)
+        return;
+
+#if (CLI_DESCR_MODE == 1)
+    if (descr[0] == CLI_DESCR_MARK) {
+        _print_compressed(descr);
+        return;
+    }
+#endif
+
+    CLI_PrintStr((char*) descr);
+}
@@ -0,0 +1,55 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#ifndef _CLI_DESCR_H_
+#define _CLI_DESCR_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Command descriptions, wrap description of cli_add_new_cmd with CLI_DESCR(ID, "..."),
+ * ID is unique identifier of description:
+ *   CLI_DESCR_MODE 0 - plain strings
+ *   CLI_DESCR_MODE 1 - compressed with shared word dictionary, cli_descr_data.h is
+ *                      generated by "tools/cli_descr_gen.py -o cli_descr_data.h <sources>",
+ *                      CLI_DESCR selects CLI_DESCR_ID_<ID> of it, original string is not used
+ *   CLI_DESCR_MODE 2 - stripped, "help" prints only names
+ */
+
+#define CLI_DESCR_MARK          ('\001')                    // first char of compressed description
+
+#if (CLI_DESCR_MODE == 2)
+#define CLI_DESCR(id_, s_)      ((const char*) NULL)
+#elif (CLI_DESCR_MODE == 1)
+#include "cli_descr_data.h"
+#define CLI_DESCR(id_, s_)      ((const char*) CLI_DESCR_ID_##id_)
+#else
+#define CLI_DESCR(id_, s_)      (s_)
+#endif
+
+/**
+ * @brief Print description, compressed description is decoded into output by chunks
+ * @param descr - plain or compressed description, NULL - nothing
+ * */
+void cli_descr_print(const char* descr);
+
+#endif // _CLI_DESCR_H_
@@ -35,31 +35,16 @@
 #include "cli_queue.h"
 #include "tinystring.h"
 
-#define INPUT_COUNT_BUFFER      (2)
-
-typedef struct
-{
-    char Data[CLI_CMD_BUF_SIZE + 1];            // buffer
-    int16_t CursorInBuffer;                     // cursor position
-    int16_t BufferCount;                        // count entered symbols
-}Buffer_t;
-
-struct
-{
-    Buffer_t Buffers[INPUT_COUNT_BUFFER];       // buffers commands
-    Buffer_t* CurBuffer;                        // processing buffer
-    CLI_Queue_t Symbols;                        // queue symbols input
-    CLI_InputBufferType_t CurrentBuffer;        // current processing buffer
-}CLI_Input_s;
+static CLI_Input_t* CLI_Input_s;                // line editor of current session
 
 static void _add_char(char c)
 {
     CLI_PUT_CHAR(c);
     
-    CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->CursorInBuffer] = c;
-    CLI_Input_s.CurBuffer->BufferCount++;
-    CLI_Input_s.CurBuffer->CursorInBuffer++;
-    CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->BufferCount] = '\0';
+    CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->CursorInBuffer] = c;
+    CLI_Input_s->CurBuffer->BufferCount++;
+    CLI_Input_s->CurBuffer->CursorInBuffer++;
+    CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->BufferCount] = '\0';
 }
 
 static void _rem_char(void)
@@ -68,9 +53,9 @@ static void _rem_char(void)
     CLI_PUT_CHAR(' ');
     CLI_PUT_CHAR(CLI_KEY_BACKSPACE);
     
-    CLI_Input_s.CurBuffer->CursorInBuffer--;
-    CLI_Input_s.CurBuffer->BufferCount--;
-    CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->BufferCount] = '\0';
+    CLI_Input_s->CurBuffer->CursorInBuffer--;
+    CLI_Input_s->CurBuffer->BufferCount--;
+    CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->BufferCount] = '\0';
 }
 
 void cli_input_refresh(const char* newCmd)
@@ -78,18 +63,19 @@ void cli_input_refresh(const char* newCmd)
     CLI_PUT_CHAR('\r');
     CLI_PRINTF(STRING_TERM_ARROW);
 
-    if (CLI_Input_s.CurBuffer->Data != newCmd)
+    if (CLI_Input_s->CurBuffer->Data != newCmd)
     {
         uint32_t lenNewCmd = _strlen(newCmd);
-        uint32_t lenCurCmd = CLI_Input_s.CurBuffer->BufferCount;
-        memcpy(CLI_Input_s.CurBuffer->Data, newCmd, lenNewCmd);
+        uint32_t lenCurCmd = CLI_Input_s->CurBuffer->BufferCount;
+        cli_memcpy(CLI_Input_s->CurBuffer->Data, newCmd, lenNewCmd);
+        CLI_Input_s->CurBuffer->Data[lenNewCmd] = '\0';
         
-        CLI_Input_s.CurBuffer->BufferCount = lenNewCmd;
-        CLI_Input_s.CurBuffer->CursorInBuffer = lenNewCmd;
+        CLI_Input_s->CurBuffer->BufferCount = lenNewCmd;
+        CLI_Input_s->CurBuffer->CursorInBuffer = lenNewCmd;
 
         for(uint8_t i = 0; i < lenNewCmd; i++)
         {
-            CLI_PUT_CHAR(CLI_Input_s.CurBuffer->Data[i]);
+            CLI_PUT_CHAR(CLI_Input_s->CurBuffer->Data[i]);
         }
 
         uint8_t cntSpcChar = 0;
@@ -105,42 +91,42 @@ void cli_input_refresh(const char* newCmd)
     }
     else
     {
-        for(uint8_t i = 0; i < CLI_Input_s.CurBuffer->BufferCount; i++)
+        for(uint8_t i = 0; i < CLI_Input_s->CurBuffer->BufferCount; i++)
         {
-            CLI_PUT_CHAR(CLI_Input_s.CurBuffer->Data[i]);
+            CLI_PUT_CHAR(CLI_Input_s->CurBuffer->Data[i]);
         }
     }
 }
 
 bool cli_input_is_empty(void)
 {
-    return CLI_Input_s.CurBuffer->BufferCount == 0;
+    return CLI_Input_s->CurBuffer->BufferCount == 0;
 }
 
 bool cli_input_is_full(void)
 {
-    return CLI_Input_s.CurBuffer->BufferCount >= CLI_CMD_BUF_SIZE;
+    return CLI_Input_s->CurBuffer->BufferCount >= CLI_CMD_BUF_SIZE;
 }
 
 void cli_input_rem_char(void)
 {
 
-    if (CLI_Input_s.CurBuffer->CursorInBuffer != CLI_Input_s.CurBuffer->BufferCount)
+    if (CLI_Input_s->CurBuffer->CursorInBuffer != CLI_Input_s->CurBuffer->BufferCount)
     {
         // save current position cursor
-        uint8_t tmpPos = CLI_Input_s.CurBuffer->CursorInBuffer - 1;
+        uint8_t tmpPos = CLI_Input_s->CurBuffer->CursorInBuffer - 1;
 
-        memcpy(CLI_Input_s.Buffers[TransitBuffer].Data, CLI_Input_s.CurBuffer->Data, tmpPos);
-        memcpy(CLI_Input_s.Buffers[TransitBuffer].Data + tmpPos, CLI_Input_s.CurBuffer->Data + tmpPos + 1, CLI_Input_s.CurBuffer->BufferCount - tmpPos);
+        cli_memcpy(CLI_Input_s->Buffers[TransitBuffer].Data, CLI_Input_s->CurBuffer->Data, tmpPos);
+        cli_memcpy(CLI_Input_s->Buffers[TransitBuffer].Data + tmpPos, CLI_Input_s->CurBuffer->Data + tmpPos + 1, CLI_Input_s->CurBuffer->BufferCount - tmpPos);
         
-        CLI_Input_s.Buffers[TransitBuffer].Data[CLI_Input_s.CurBuffer->BufferCount - 1] = '\0';
+        CLI_Input_s->Buffers[TransitBuffer].Data[CLI_Input_s->CurBuffer->BufferCount - 1] = '\0';
         
-        cli_input_refresh(CLI_Input_s.Buffers[TransitBuffer].Data);
+        cli_input_refresh(CLI_Input_s->Buffers[TransitBuffer].Data);
 
-        for(uint8_t pos = 0; pos < CLI_Input_s.CurBuffer->BufferCount - tmpPos; pos++)
+        for(uint8_t pos = 0; pos < CLI_Input_s->CurBuffer->BufferCount - tmpPos; pos++)
         {
             CLI_PUT_CHAR(CLI_KEY_LSHIFT);
-            CLI_Input_s.CurBuffer->CursorInBuffer--;
+            CLI_Input_s->CurBuffer->CursorInBuffer--;
         }
     }
     else
@@ -151,25 +137,25 @@ void cli_input_rem_char(void)
 
 void cli_input_add_char(char c)
 {
-    if (CLI_Input_s.CurBuffer->CursorInBuffer != CLI_Input_s.CurBuffer->BufferCount)
+    if (CLI_Input_s->CurBuffer->CursorInBuffer != CLI_Input_s->CurBuffer->BufferCount)
     {
-        uint8_t tmpPos = CLI_Input_s.CurBuffer->CursorInBuffer;
-        memcpy(CLI_Input_s.Buffers[TransitBuffer].Data, CLI_Input_s.CurBuffer->Data, tmpPos);
-        memcpy(CLI_Input_s.Buffers[TransitBuffer].Data + tmpPos, &c, 1);
-        memcpy(CLI_Input_s.Buffers[TransitBuffer].Data + tmpPos + 1, CLI_Input_s.CurBuffer->Data + tmpPos, CLI_Input_s.CurBuffer->BufferCount - tmpPos);
-        CLI_Input_s.Buffers[TransitBuffer].Data[CLI_Input_s.CurBuffer->BufferCount + 1] = '\0';
+        uint8_t tmpPos = CLI_Input_s->CurBuffer->CursorInBuffer;
+        cli_memcpy(CLI_Input_s->Buffers[TransitBuffer].Data, CLI_Input_s->CurBuffer->Data, tmpPos);
+        cli_memcpy(CLI_Input_s->Buffers[TransitBuffer].Data + tmpPos, &c, 1);
+        cli_memcpy(CLI_Input_s->Buffers[TransitBuffer].Data + tmpPos + 1, CLI_Input_s->CurBuffer->Data + tmpPos, CLI_Input_s->CurBuffer->BufferCount - tmpPos);
+        CLI_Input_s->Buffers[TransitBuffer].Data[CLI_Input_s->CurBuffer->BufferCount + 1] = '\0';
         
-        CLI_Input_s.CurBuffer->BufferCount++;
-        CLI_Input_s.CurBuffer->CursorInBuffer++;
-        CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->BufferCount] = '\0';
+        CLI_Input_s->CurBuffer->BufferCount++;
+        CLI_Input_s->CurBuffer->CursorInBuffer++;
+        CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->BufferCount] = '\0';
 
         tmpPos++;
-        cli_input_refresh(CLI_Input_s.Buffers[TransitBuffer].Data);
+        cli_input_refresh(CLI_Input_s->Buffers[TransitBuffer].Data);
 
-        for(uint8_t pos = 0; pos < CLI_Input_s.CurBuffer->BufferCount - tmpPos; pos++)
+        for(uint8_t pos = 0; pos < CLI_Input_s->CurBuffer->BufferCount - tmpPos; pos++)
         {
             CLI_PUT_CHAR(CLI_KEY_LSHIFT);
-            CLI_Input_s.CurBuffer->CursorInBuffer--;
+            CLI_Input_s->CurBuffer->CursorInBuffer--;
         }
     }
     else
@@ -183,22 +169,62 @@ void cli_input_init(void)
 {
     for(uint32_t i = 0; i < INPUT_COUNT_BUFFER; i++)
     {
-        CLI_Input_s.Buffers[i].Data[0] = '\0';
-        CLI_Input_s.Buffers[i].BufferCount = 0;
-        CLI_Input_s.Buffers[i].CursorInBuffer = 0;
+        CLI_Input_s->Buffers[i].Data[0] = '\0';
+        CLI_Input_s->Buffers[i].BufferCount = 0;
+        CLI_Input_s->Buffers[i].CursorInBuffer = 0;
     }
     
-    CLI_Input_s.CurBuffer = &CLI_Input_s.Buffers[MainBuffer];
+    CLI_Input_s->CurBuffer = &CLI_Input_s->Buffers[MainBuffer];
+    CLI_Input_s->EscState = EscNone;
     
-    cli_queue_init(&CLI_Input_s.Symbols, 3, sizeof(char), QUEUE_FORCED_PUSH_POP_Msk);
+    cli_queue_init(&CLI_Input_s->Symbols, INPUT_SYMBOLS_SIZE, sizeof(char), QUEUE_FORCED_PUSH_POP_Msk);
+    CLI_Input_s->Symbols.ptrObj = CLI_Input_s->SymbolsBuf;
     
-    for(uint8_t i = 0; i < 3; i++)
+    for(uint8_t i = 0; i < INPUT_SYMBOLS_SIZE; i++)
     {
         char c = 0;
-        cli_queue_push(&CLI_Input_s.Symbols, &c);
+        cli_queue_push(&CLI_Input_s->Symbols, &c);
     }
 }
 
+/**
+ * @brief Track escape sequence, its chars must not get into buffer
+ * @return true - char is part of escape sequence
+ * */
+static bool _is_escape_char(char c)
+{
+    switch (CLI_Input_s->EscState)
+    {
+        case EscStart:
+            if (c == '[')
+                CLI_Input_s->EscState = EscCsi;
+            else if (c != 0x1B)
+                CLI_Input_s->EscState = EscNone;
+            return (c == '[') || (c == 0x1B);
+
+        case EscCsi:
+            CLI_Input_s->EscState = ((c >= '0') && (c <= '9')) ? EscParam : EscNone;
+            return true;
+
+        case EscParam:
+            CLI_Input_s->EscState = EscNone;
+            if (c == '~')
+                return true;
+            break;
+
+        default:
+            break;
+    }
+
+    if (c == 0x1B)
+    {
+        CLI_Input_s->EscState = EscStart;
+        return true;
+    }
+
+    return false;
+}
+
 static const uint8_t arr_up[]       = {0x1B, 0x5B, 0x41}; // Key code button "UP"
 static const uint8_t arr_down[]     = {0x1B, 0x5B, 0x42}; // Key code button "DOWN"
 static const uint8_t arr_right[]    = {0x1B, 0x5B, 0x43}; // Key code button "RIGHT"
@@ -211,24 +237,24 @@ static const uint8_t end[]          = {0x1B, 0x5B, 0x34}; // Key code button "EN
 CLI_InputValue_t cli_input_put_char(char c)
 {
     CLI_InputValue_t iv;
+    bool isEscape = _is_escape_char(c);
     
-    cli_queue_push(&CLI_Input_s.Symbols, &c);
+    cli_queue_push(&CLI_Input_s->Symbols, &c);
     
-    if (cli_queue_is_equal(&CLI_Input_s.Symbols, arr_up, 3))            {c = CLI_KEY_UP;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, arr_down, 3))     {c = CLI_KEY_DOWN;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, arr_right, 3))    {c = CLI_KEY_RIGHT;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, arr_left, 3))     {c = CLI_KEY_LEFT;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, arr_esc, 3))      {c = CLI_KEY_ESCAPE;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, del, 3))          {c = CLI_KEY_DEL;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, home, 3))         {c = CLI_KEY_HOME;}
-    else if (cli_queue_is_equal(&CLI_Input_s.Symbols, end, 3))          {c = CLI_KEY_END;}
+    if (cli_queue_is_equal(&CLI_Input_s->Symbols, arr_up, 3))            {c = CLI_KEY_UP;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, arr_down, 3))     {c = CLI_KEY_DOWN;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, arr_right, 3))    {c = CLI_KEY_RIGHT;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, arr_left, 3))     {c = CLI_KEY_LEFT;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, arr_esc, 3))      {c = CLI_KEY_ESCAPE;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, del, 3))          {c = CLI_KEY_DEL;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, home, 3))         {c = CLI_KEY_HOME;}
+    else if (cli_queue_is_equal(&CLI_Input_s->Symbols, end, 3))          {c = CLI_KEY_END;}
     
-    iv.isValid = ((CLI_Input_s.CurBuffer->BufferCount < CLI_CMD_BUF_SIZE) ||
+    iv.isValid = ((CLI_Input_s->CurBuffer->BufferCount < CLI_CMD_BUF_SIZE) ||
                         (c == CLI_KEY_BACKSPACE) ||
                         (c == CLI_KEY_ENTER)	||
                         (c == CHAR_INTERRUPT));
-    if ( (c != '\n') && (c != '\r')) // drop characters \r or \n
-        iv.isAlphaBet = c;
+    iv.isAlphaBet = (c != '\n') && (c != '\r') && !isEscape; // drop characters \r, \n and escape sequences
                     
     iv.keyCode = c;
     return iv;
@@ -236,33 +262,35 @@ CLI_InputValue_t cli_input_put_char(char c)
 
 void cli_input_cache(void)
 {
-    CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->BufferCount] = '\0';
-    memcpy(CLI_Input_s.Buffers[TransitBuffer].Data, CLI_Input_s.CurBuffer->Data, CLI_Input_s.CurBuffer->BufferCount + 1);
+    CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->BufferCount] = '\0';
+    cli_memcpy(CLI_Input_s->Buffers[TransitBuffer].Data, CLI_Input_s->CurBuffer->Data, CLI_Input_s->CurBuffer->BufferCount + 1);
 }
 
 void cli_input_reset(void)
 {
-    CLI_Input_s.CurBuffer->CursorInBuffer = CLI_Input_s.CurBuffer->BufferCount = 0;
-    CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->BufferCount] = '\0';
+    CLI_Input_s->CurBuffer->CursorInBuffer = CLI_Input_s->CurBuffer->BufferCount = 0;
+    CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->BufferCount] = '\0';
 }
 
-char cli_input_get_last_char(){ return CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->BufferCount - 1];	}
+char cli_input_get_last_char(){ return CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->BufferCount - 1];	}
+
+uint16_t cli_input_get_cursor(void){ return CLI_Input_s->CurBuffer->CursorInBuffer; }
 
-void cli_input_cursor_to(uint16_t pos){ CLI_Input_s.CurBuffer->CursorInBuffer = pos; }
+void cli_input_cursor_to(uint16_t pos){ CLI_Input_s->CurBuffer->CursorInBuffer = pos; }
 
-void cli_input_cursor_shift(int16_t shift){ CLI_Input_s.CurBuffer->CursorInBuffer += shift; }
+void cli_input_cursor_shift(int16_t shift){ CLI_Input_s->CurBuffer->CursorInBuffer += shift; }
 
-char* cli_input_get_buffer(CLI_InputBufferType_t type){ return CLI_Input_s.Buffers[type].Data; }
+char* cli_input_get_buffer(CLI_InputBufferType_t type){ return CLI_Input_s->Buffers[type].Data; }
 
 void cli_input_set_buffer(CLI_InputBufferType_t type, char* buffer, uint32_t len)
 {
-    memcpy(CLI_Input_s.Buffers[type].Data, buffer, len);
-    CLI_Input_s.CurBuffer->BufferCount = CLI_Input_s.CurBuffer->CursorInBuffer = len;
+    cli_memcpy(CLI_Input_s->Buffers[type].Data, buffer, len);
+    CLI_Input_s->CurBuffer->BufferCount = CLI_Input_s->CurBuffer->CursorInBuffer = len;
 }
 
 void cli_input_cursor_to_home(void)
 {
-    while(CLI_Input_s.CurBuffer->CursorInBuffer > 0)
+    while(CLI_Input_s->CurBuffer->CursorInBuffer > 0)
     {
         CLI_PUT_CHAR(CLI_KEY_LSHIFT);
         cli_input_cursor_shift(-1);
@@ -271,16 +299,16 @@ void cli_input_cursor_to_home(void)
 
 void cli_input_cursor_to_end(void)
 {
-    while(CLI_Input_s.CurBuffer->CursorInBuffer < CLI_Input_s.CurBuffer->BufferCount)
+    while(CLI_Input_s->CurBuffer->CursorInBuffer < CLI_Input_s->CurBuffer->BufferCount)
     {
-        CLI_PUT_CHAR(CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->CursorInBuffer]);
+        CLI_PUT_CHAR(CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->CursorInBuffer]);
         cli_input_cursor_shift(1);
     }
 }
 
 void cli_input_cursor_to_left(void)
 {
-    if (CLI_Input_s.CurBuffer->CursorInBuffer > 0)
+    if (CLI_Input_s->CurBuffer->CursorInBuffer > 0)
     {
         cli_input_cursor_shift(-1);
         CLI_PUT_CHAR(CLI_KEY_LSHIFT);
@@ -289,28 +317,31 @@ void cli_input_cursor_to_left(void)
 
 void cli_input_cursor_to_right(void)
 {
-    if (CLI_Input_s.CurBuffer->CursorInBuffer < CLI_Input_s.CurBuffer->BufferCount)
+    if (CLI_Input_s->CurBuffer->CursorInBuffer < CLI_Input_s->CurBuffer->BufferCount)
     {
-        CLI_PUT_CHAR(CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->CursorInBuffer]);
+        CLI_PUT_CHAR(CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->CursorInBuffer]);
         cli_input_cursor_shift(1);
     }	
 }
 
 void cli_input_delete(void)
 {
-    if ((CLI_Input_s.CurBuffer->CursorInBuffer != CLI_Input_s.CurBuffer->BufferCount) && (!cli_input_is_empty()))
+    if ((CLI_Input_s->CurBuffer->CursorInBuffer != CLI_Input_s->CurBuffer->BufferCount) && (!cli_input_is_empty()))
     {
+        // step over deleted char and remove it as backspace
         cli_input_cursor_shift(1);
-        if(CLI_Input_s.CurBuffer->CursorInBuffer != CLI_Input_s.CurBuffer->BufferCount)
-        {
-            CLI_PUT_CHAR(CLI_Input_s.CurBuffer->Data[CLI_Input_s.CurBuffer->CursorInBuffer - 1]);
-        }
+        CLI_PUT_CHAR(CLI_Input_s->CurBuffer->Data[CLI_Input_s->CurBuffer->CursorInBuffer - 1]);
         cli_input_rem_char();
     }	
 }
 
 void cli_input_backspace(void)
 {
-    if (!cli_input_is_empty() && (CLI_Input_s.CurBuffer->CursorInBuffer > 0))
+    if (!cli_input_is_empty() && (CLI_Input_s->CurBuffer->CursorInBuffer > 0))
         cli_input_rem_char();
 }
+
+void cli_input_bind(CLI_Input_t* input)
+{
+    CLI_Input_s = input;
+}
@@ -34,6 +34,10 @@
 #define _CLI_INPUT_H_
 
 #include "cli_config.h"
+#include "cli_queue.h"
+
+#define INPUT_COUNT_BUFFER      (2)
+#define INPUT_SYMBOLS_SIZE      (3)                 // last chars for key codes of escape sequences
 
 typedef struct
 {
@@ -48,6 +52,35 @@ typedef enum
     TransitBuffer	= 0x01
 }CLI_InputBufferType_t;
 
+typedef enum
+{
+    EscNone = 0,                                // not in escape sequence
+    EscStart,                                   // after ESC
+    EscCsi,                                     // after ESC '['
+    EscParam                                    // after ESC '[' digit, waits '~' of "ESC [ n ~"
+}CLI_InputEscState_t;
+
+typedef struct
+{
+    char Data[CLI_CMD_BUF_SIZE + 1];            // buffer
+    int16_t CursorInBuffer;                     // cursor position
+    int16_t BufferCount;                        // count entered symbols
+}Buffer_t;
+
+/** @brief Line editor of one session */
+typedef struct
+{
+    Buffer_t Buffers[INPUT_COUNT_BUFFER];       // buffers commands
+    Buffer_t* CurBuffer;                        // processing buffer
+    CLI_Queue_t Symbols;                        // queue symbols input
+    char SymbolsBuf[INPUT_SYMBOLS_SIZE];        // storage of Symbols
+    CLI_InputBufferType_t CurrentBuffer;        // current processing buffer
+    CLI_InputEscState_t EscState;               // state of escape sequence parser
+}CLI_Input_t;
+
+/** @brief Select line editor for next calls (session) */
+void cli_input_bind(CLI_Input_t* input);
+
 /** @brief Init CLI imput parser module */
 void cli_input_init(void);
 
@@ -96,6 +129,9 @@ void cli_input_cursor_to_home(void);
 /** @brief Send "chars key"  end  buttom to user */
 void cli_input_cursor_to_end();
 
+/** @brief Get cursor position in buffer */
+uint16_t cli_input_get_cursor(void);
+
 /** @brief Send "chars key"  jump cursor to numper chars user */
 void cli_input_cursor_to(uint16_t pos);
 
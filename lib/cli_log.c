@@ -34,48 +34,44 @@
 #include "string.h"
 
 
-static struct{
-	char cmds[CLI_CMD_LOG_SIZE][CLI_CMD_BUF_SIZE];
-	int8_t _curCmd;
-	int8_t _cntCmd;
-}CLI_Log_s;
+static CLI_Log_t* CLI_Log_s;                    // history of current session
 
 void cli_log_init(void)
 {
-    CLI_Log_s._cntCmd = 0;
+    CLI_Log_s->_cntCmd = 0;
     cli_log_cur_reset();
 	
 	for(uint8_t i = 0; i < CLI_CMD_LOG_SIZE; i++)
 	{
-        CLI_Log_s.cmds[i][0] = '\0';
+        CLI_Log_s->cmds[i][0] = '\0';
 	}
 }
 
 void cli_log_cmd_push(const char* cmd)
 {
-	if (CLI_Log_s._cntCmd < CLI_CMD_LOG_SIZE)
+	if (CLI_Log_s->_cntCmd < CLI_CMD_LOG_SIZE)
 	{
-		if (CLI_Log_s._cntCmd > 0)
+		if (CLI_Log_s->_cntCmd > 0)
 		{
-			if (_strcmp(cmd, (const char*) CLI_Log_s.cmds[CLI_Log_s._cntCmd - 1]) == 0)
+			if (_strcmp(cmd, (const char*) CLI_Log_s->cmds[CLI_Log_s->_cntCmd - 1]) == 0)
 			{
-				cli_memcpy(CLI_Log_s.cmds[CLI_Log_s._cntCmd], cmd, CLI_CMD_BUF_SIZE);
-				CLI_Log_s._cntCmd++;
+				cli_memcpy(CLI_Log_s->cmds[CLI_Log_s->_cntCmd], cmd, CLI_CMD_BUF_SIZE);
+				CLI_Log_s->_cntCmd++;
 			}
 		}
 		else
 		{
-			cli_memcpy(CLI_Log_s.cmds[CLI_Log_s._cntCmd], cmd, CLI_CMD_BUF_SIZE);
-			CLI_Log_s._cntCmd++;
+			cli_memcpy(CLI_Log_s->cmds[CLI_Log_s->_cntCmd], cmd, CLI_CMD_BUF_SIZE);
+			CLI_Log_s->_cntCmd++;
 		}
 	}
 	else
 	{
-		if (_strcmp(cmd, (const char*) CLI_Log_s.cmds[CLI_Log_s._cntCmd - 1]) == 0)
+		if (_strcmp(cmd, (const char*) CLI_Log_s->cmds[CLI_Log_s->_cntCmd - 1]) == 0)
 		{
-			cli_memcpy(&CLI_Log_s.cmds[0][0], &CLI_Log_s.cmds[1][0], CLI_CMD_BUF_SIZE * (CLI_CMD_LOG_SIZE - 1));
-			cli_memcpy(&CLI_Log_s.cmds[CLI_Log_s._cntCmd - 1][0], cmd, CLI_CMD_BUF_SIZE);
-            CLI_Log_s._cntCmd = CLI_CMD_LOG_SIZE;
+			cli_memmove(&CLI_Log_s->cmds[0][0], &CLI_Log_s->cmds[1][0], CLI_CMD_BUF_SIZE * (CLI_CMD_LOG_SIZE - 1));
+			cli_memcpy(&CLI_Log_s->cmds[CLI_Log_s->_cntCmd - 1][0], cmd, CLI_CMD_BUF_SIZE);
+            CLI_Log_s->_cntCmd = CLI_CMD_LOG_SIZE;
 		}
 	}
 }
@@ -84,7 +80,7 @@ const char* cli_log_cmd_get(uint8_t index)
 {
 	if (index < CLI_CMD_LOG_SIZE)
 	{
-		return &CLI_Log_s.cmds[index][0];
+		return &CLI_Log_s->cmds[index][0];
 	}
 
 	return NULL;
@@ -92,10 +88,10 @@ const char* cli_log_cmd_get(uint8_t index)
 
 const char* cli_log_get_next_cmd(void)
 {
-	if (CLI_Log_s._curCmd < CLI_Log_s._cntCmd - 1)
+	if (CLI_Log_s->_curCmd < CLI_Log_s->_cntCmd - 1)
 	{
-		CLI_Log_s._curCmd++;
-		return &CLI_Log_s.cmds[CLI_Log_s._curCmd][0];
+		CLI_Log_s->_curCmd++;
+		return &CLI_Log_s->cmds[CLI_Log_s->_curCmd][0];
 	}
 
 	return NULL;
@@ -103,10 +99,10 @@ const char* cli_log_get_next_cmd(void)
 
 const char* cli_log_get_last_cmd(void)
 {
-	if (CLI_Log_s._curCmd > 0)
+	if (CLI_Log_s->_curCmd > 0)
 	{
-		CLI_Log_s._curCmd--;
-		return &CLI_Log_s.cmds[CLI_Log_s._curCmd][0];
+		CLI_Log_s->_curCmd--;
+		return &CLI_Log_s->cmds[CLI_Log_s->_curCmd][0];
 	}
 
 	return NULL;
@@ -114,5 +110,10 @@ const char* cli_log_get_last_cmd(void)
 
 void cli_log_cur_reset(void)
 {
-    CLI_Log_s._curCmd = CLI_Log_s._cntCmd;
+    CLI_Log_s->_curCmd = CLI_Log_s->_cntCmd;
+}
+
+void cli_log_bind(CLI_Log_t* log)
+{
+    CLI_Log_s = log;
 }
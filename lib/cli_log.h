@@ -38,6 +38,16 @@
 #include "cli_queue.h"
 
 
+/** @brief History of commands of one session */
+typedef struct{
+	char cmds[CLI_CMD_LOG_SIZE][CLI_CMD_BUF_SIZE];
+	int8_t _curCmd;
+	int8_t _cntCmd;
+}CLI_Log_t;
+
+/** @brief Select history for next calls (session) */
+void cli_log_bind(CLI_Log_t* log);
+
 void cli_log_init();
 void cli_log_cmd_push(const char* cmd);
 const char* cli_log_cmd_get(uint8_t index);
@@ -0,0 +1,189 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_log_rl.h"
+
+#if (CLI_LOG_RATE_LIMIT_EN == 1)
+
+#if ((CLI_LOG_RL_SLOTS & (CLI_LOG_RL_SLOTS - 1)) != 0) || (CLI_LOG_RL_SLOTS < 2)
+#error "CLI_LOG_RL_SLOTS must be power of 2, at least 2"
+#endif
+
+#define RL_WAYS                 (2U)                                // slots of one set
+#define RL_SETS                 (CLI_LOG_RL_SLOTS / RL_WAYS)
+#define RL_FORMAT_MAX           (24)                                // printed chars of format in summary
+
+/** @brief State of one log call site */
+typedef struct{
+    uint32_t key;                   // call site key, 0 - free slot
+    const char* format;             // format string of call site
+    uint32_t startMs;               // start current window
+    uint16_t line;                  // line of call site
+    uint16_t count;                 // printed messages in window
+    uint16_t suppressed;            // suppressed messages in window
+    uint8_t level;                  // log level of call site
+}CLI_LogRlSlot_t;
+
+static struct{
+    CLI_LogRlSlot_t slots[CLI_LOG_RL_SLOTS];    // RL_SETS sets of RL_WAYS slots
+    uint16_t limits[CLI_LOG_LEVEL_COUNT];   // max messages in window, 0 - without limit
+    uint32_t windowMs;                      // suppress window
+    uint8_t pending;                        // count slots with suppressed messages
+}CLI_LogRl_s;
+
+static const char* const _level_names[CLI_LOG_LEVEL_COUNT] = {"DEBUG", "INFO", "ERROR"};
+
+static inline uint8_t _set_index(uint32_t key)
+{
+    return (uint8_t) (((key * 2654435761u) >> 16) & (RL_SETS - 1));
+}
+
+static void _print_summary(CLI_LogRlSlot_t* slot)
+{
+    const char* f = slot->format;
+    int len = 0;
+
+    // first line of format names call site
+    while ((*f == '\r') || (*f == '\n'))
+        f++;
+    while ((len < RL_FORMAT_MAX) && (f[len] != '\0') && (f[len] != '\r') && (f[len] != '\n'))
+        len++;
+
+#if (DEBUG_TIMESTAMP == 1)
+    CLI_PRINTF("%s [%s] \"%.*s\" (line %u) repeated %u times\r\n", cli_time_get_curr_time_str(),
+               _level_names[slot->level], len, f, (unsigned int) slot->line, (unsigned int) slot->suppressed);
+#else
+    CLI_PRINTF("\n[%s] \"%.*s\" (line %u) repeated %u times", _level_names[slot->level], len, f,
+               (unsigned int) slot->line, (unsigned int) slot->suppressed);
+#endif
+    slot->suppressed = 0;
+    CLI_LogRl_s.pending--;
+}
+
+void cli_log_rl_init(void)
+{
+    for (uint8_t i = 0; i < CLI_LOG_RL_SLOTS; i++) {
+        CLI_LogRl_s.slots[i].key = 0;
+        CLI_LogRl_s.slots[i].count = 0;
+        CLI_LogRl_s.slots[i].suppressed = 0;
+    }
+
+    CLI_LogRl_s.limits[CLI_LOG_LEVEL_DEBUG] = CLI_LOG_RL_DEBUG_MAX;
+    CLI_LogRl_s.limits[CLI_LOG_LEVEL_INFO] = CLI_LOG_RL_INFO_MAX;
+    CLI_LogRl_s.limits[CLI_LOG_LEVEL_ERROR] = CLI_LOG_RL_ERROR_MAX;
+    CLI_LogRl_s.windowMs = CLI_LOG_RL_WINDOW_MS;
+    CLI_LogRl_s.pending = 0;
+}
+
+bool cli_log_rl_check(CLI_LogLevel_t level, const char* format, uint16_t line)
+{
+    uint16_t limit = CLI_LogRl_s.limits[level];
+
+    if (limit == 0)
+        return true;
+
+    uint32_t key = (uint32_t) (uintptr_t) format ^ ((uint32_t) line << 20);
+    if (key == 0)
+        key = 1;
+
+    CLI_LogRlSlot_t* set = &CLI_LogRl_s.slots[_set_index(key) * RL_WAYS];
+    CLI_LogRlSlot_t* slot = NULL;
+    uint32_t now = CLI_GETMS();
+
+    // call site in set, else victim: free slot, expired window, oldest window
+    for (uint8_t i = 0; i < RL_WAYS; i++) {
+        if (set[i].key == key) {
+            slot = &set[i];
+            break;
+        }
+    }
+    bool found = (slot != NULL);
+    for (uint8_t i = 0; !found && (i < RL_WAYS); i++) {
+        if ((set[i].key == 0) || ((now - set[i].startMs) >= CLI_LogRl_s.windowMs)) {
+            slot = &set[i];
+            break;
+        }
+        if ((slot == NULL) || ((int32_t) (set[i].startMs - slot->startMs) < 0))
+            slot = &set[i];
+    }
+
+    // new call site or window expired - start new window
+    if (!found || ((now - slot->startMs) >= CLI_LogRl_s.windowMs)) {
+        if (slot->suppressed)
+            _print_summary(slot);
+
+        slot->key = key;
+        slot->format = format;
+        slot->line = line;
+        slot->level = level;
+        slot->startMs = now;
+        slot->count = 1;
+        return true;
+    }
+
+    if (slot->count < limit) {
+        slot->count++;
+        return true;
+    }
+
+    if (slot->suppressed == 0)
+        CLI_LogRl_s.pending++;
+
+    if (slot->suppressed < UINT16_MAX)
+        slot->suppressed++;
+
+    return false;
+}
+
+void cli_log_rl_service(void)
+{
+    if (CLI_LogRl_s.pending == 0)
+        return;
+
+    uint32_t now = CLI_GETMS();
+
+    for (uint8_t i = 0; i < CLI_LOG_RL_SLOTS; i++) {
+        CLI_LogRlSlot_t* slot = &CLI_LogRl_s.slots[i];
+
+        if (slot->suppressed && ((now - slot->startMs) >= CLI_LogRl_s.windowMs)) {
+            _print_summary(slot);
+            slot->key = 0;
+        }
+    }
+}
+
+void cli_log_rl_set_limit(CLI_LogLevel_t level, uint16_t maxCount)
+{
+    if (level < CLI_LOG_LEVEL_COUNT)
+        CLI_LogRl_s.limits[level] = maxCount;
+}
+
+void cli_log_rl_set_window(uint32_t windowMs)
+{
+    CLI_LogRl_s.windowMs = windowMs;
+}
+
+uint32_t cli_log_rl_get_ram_size(void)
+{
+    return sizeof(CLI_LogRl_s);
+}
+
+#endif // CLI_LOG_RATE_LIMIT_EN == 1
@@ -0,0 +1,66 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_LOG_RL_H_
+#define _CLI_LOG_RL_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Log level for rate limit */
+typedef enum{
+    CLI_LOG_LEVEL_DEBUG = 0,
+    CLI_LOG_LEVEL_INFO,
+    CLI_LOG_LEVEL_ERROR,
+    CLI_LOG_LEVEL_COUNT
+} CLI_LogLevel_t;
+
+/** @brief Init log rate limit module */
+void cli_log_rl_init(void);
+
+/**
+ * @brief Check whether message of call site may be printed now
+ * @param level - log level
+ * @param format - format string of call site
+ * @param line - line of call site
+ * @return true - print message, false - message suppressed
+ * @note call sites are kept in 2-way sets, summary names format and line
+ * */
+bool cli_log_rl_check(CLI_LogLevel_t level, const char* format, uint16_t line);
+
+/** @brief Print "repeated N times" summaries for expired windows */
+void cli_log_rl_service(void);
+
+/**
+ * @brief Set max count messages of one call site in window
+ * @param level - log level
+ * @param maxCount - max messages in window, 0 - without limit
+ * */
+void cli_log_rl_set_limit(CLI_LogLevel_t level, uint16_t maxCount);
+
+/** @brief Set suppress window in ms */
+void cli_log_rl_set_window(uint32_t windowMs);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_log_rl_get_ram_size(void);
+
+#endif // _CLI_LOG_RL_H_
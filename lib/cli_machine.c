@@ -0,0 +1,310 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_machine.h"
+#include "cli_io.h"
+
+#if (CLI_MACHINE_EN == 1)
+
+#define MACHINE_SLOTS           (CLI_MACHINE_QUEUE_SIZE + 1U)               // queued lines and line being received
+#define MACHINE_HEAD_MAX        (1U + CLI_MACHINE_TAG_SIZE + 1U + 3U + 1U)  // "#<tag> <status> "
+
+/** @brief Received request line */
+typedef struct{
+    char data[CLI_CMD_BUF_SIZE + 1];
+    uint8_t len;
+    bool overflow;                                  // line longer than CLI_CMD_BUF_SIZE
+}CLI_MachineLine_t;
+
+/** @brief Machine mode */
+static struct{
+    CLI_MachineLine_t lines[MACHINE_SLOTS];         // ring of lines, one slot is always free for receive
+    char reply[MACHINE_HEAD_MAX + CLI_MACHINE_REPLY_SIZE + 4];  // head, payload, "\+", "\r\n"
+    char tag[CLI_MACHINE_TAG_SIZE + 1];             // tag of current request
+    uint16_t len;                                   // payload length
+    uint8_t newLines;                               // new lines of output not written to payload yet
+    volatile uint8_t wr;                            // line being received
+    volatile uint8_t rd;                            // next queued line
+    CLI_Session_t* owner;                           // session in machine mode
+    bool active;
+    bool stop;                                      // switch off after reply of current request
+    bool capture;                                   // output of command goes to payload
+    bool cut;                                       // payload is cut
+}CLI_Machine_s;
+
+/** @brief Copy tag of line, return command string */
+static const char* _take_tag(const char* line, char* tag)
+{
+    uint8_t n = 0;
+
+    if (*line == '#') {
+        line++;
+        for (; (*line != '\0') && (*line != ' '); line++) {
+            if (n < CLI_MACHINE_TAG_SIZE)
+                tag[n++] = *line;
+        }
+        while (*line == ' ')
+            line++;
+    }
+    tag[n] = '\0';
+
+    return line;
+}
+
+/** @brief Write "#<tag> <status>" to end of buf, return pointer on it */
+static char* _head(char* end, const char* tag, uint8_t status)
+{
+    char* p = end;
+    uint8_t n = (uint8_t) _strlen(tag);
+
+    do {
+        *--p = (char) ('0' + status % 10);
+        status /= 10;
+    } while (status != 0);
+    *--p = ' ';
+    while (n > 0)
+        *--p = tag[--n];
+    *--p = '#';
+
+    return p;
+}
+
+static void _put(const char* str, uint8_t n)
+{
+    if (CLI_Machine_s.cut)
+        return;
+
+    if (CLI_Machine_s.len + n > CLI_MACHINE_REPLY_SIZE) {
+        str = "\\+";
+        n = 2;
+        CLI_Machine_s.cut = true;
+    }
+
+    cli_memcpy(&CLI_Machine_s.reply[MACHINE_HEAD_MAX + CLI_Machine_s.len], str, n);
+    CLI_Machine_s.len += n;
+}
+
+/** @brief Output of CLI while machine mode is active */
+static void _write(const char* str, size_t len)
+{
+    if (!CLI_Machine_s.capture)
+        return;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = str[i];
+
+        if (c == '\r')
+            continue;
+
+        // leading and trailing new lines are dropped
+        if (c == '\n') {
+            if ((CLI_Machine_s.len != 0) && (CLI_Machine_s.newLines < UINT8_MAX))
+                CLI_Machine_s.newLines++;
+            continue;
+        }
+
+        for (; CLI_Machine_s.newLines > 0; CLI_Machine_s.newLines--)
+            _put("\\n", 2);
+
+        if (c == '\\')
+            _put("\\\\", 2);
+        else
+            _put(&c, 1);
+    }
+}
+
+bool cli_machine_set(bool on)
+{
+    // one session in machine mode
+    if (CLI_Machine_s.active && (CLI_Machine_s.owner != cli_session_get_current()))
+        return false;
+
+    if (on == CLI_Machine_s.active) {
+        CLI_Machine_s.stop = false;
+        return true;
+    }
+
+    if (on) {
+        CLI_Machine_s.owner = cli_session_get_current();
+        CLI_Machine_s.wr = CLI_Machine_s.rd = 0;
+        CLI_Machine_s.lines[0].len = 0;
+        CLI_Machine_s.lines[0].overflow = false;
+        CLI_Machine_s.active = true;
+        CLI_SetWrite(_write);
+
+        // reply of request which switched mode
+        cli_session_send("\r\n# 0\r\n", 7);
+    } else if (CLI_Machine_s.capture) {
+        CLI_Machine_s.stop = true;
+    } else {
+        CLI_Machine_s.active = false;
+        CLI_SetWrite(NULL);
+    }
+
+    return true;
+}
+
+bool cli_machine_is_active(void)
+{
+    return CLI_Machine_s.active && (CLI_Machine_s.owner == cli_session_get_current());
+}
+
+void cli_machine_capture(bool on)
+{
+    if (cli_machine_is_active())
+        CLI_Machine_s.capture = on;
+}
+
+bool cli_machine_put_char(char ch)
+{
+    CLI_MachineLine_t* line = &CLI_Machine_s.lines[CLI_Machine_s.wr];
+
+    if ((ch != '\r') && (ch != '\n')) {
+        if (line->len < CLI_CMD_BUF_SIZE)
+            line->data[line->len++] = ch;
+        else
+            line->overflow = true;
+        return false;
+    }
+
+    // empty line, "\r\n"
+    if (line->len == 0)
+        return false;
+
+    line->data[line->len] = '\0';
+
+    uint8_t next = (CLI_Machine_s.wr + 1U == MACHINE_SLOTS) ? 0 : CLI_Machine_s.wr + 1U;
+    if (next == CLI_Machine_s.rd) {
+        char tag[CLI_MACHINE_TAG_SIZE + 1];
+        char busy[MACHINE_HEAD_MAX + 8];
+        char* end = &busy[MACHINE_HEAD_MAX];
+
+        _take_tag(line->data, tag);
+        char* head = _head(end, tag, CLI_Err);
+        cli_memcpy(end, " busy\r\n", 7);
+        cli_session_send(head, (size_t) (end - head) + 7);
+
+        line->len = 0;
+        line->overflow = false;
+        return false;
+    }
+
+    CLI_Machine_s.lines[next].len = 0;
+    CLI_Machine_s.lines[next].overflow = false;
+    CLI_Machine_s.wr = next;
+
+    return true;
+}
+
+const char* cli_machine_begin(void)
+{
+    // request is executed in session which received it
+    if (!cli_machine_is_active())
+        return NULL;
+
+    while (CLI_Machine_s.rd != CLI_Machine_s.wr) {
+        CLI_MachineLine_t* line = &CLI_Machine_s.lines[CLI_Machine_s.rd];
+        const char* cmd = _take_tag(line->data, CLI_Machine_s.tag);
+
+        CLI_Machine_s.len = 0;
+        CLI_Machine_s.newLines = 0;
+        CLI_Machine_s.cut = false;
+        CLI_Machine_s.capture = true;
+
+        if (!line->overflow)
+            return cmd;
+
+        _put("line too long", 13);
+        cli_machine_end(CLI_ArgErr);
+    }
+
+    return NULL;
+}
+
+void cli_machine_end(uint8_t status)
+{
+    char* payload = &CLI_Machine_s.reply[MACHINE_HEAD_MAX];
+    char* end = payload + CLI_Machine_s.len;
+
+    CLI_Machine_s.capture = false;
+
+    if (CLI_Machine_s.len != 0)
+        *--payload = ' ';
+    char* head = _head(payload, CLI_Machine_s.tag, status);
+    *end++ = '\r';
+    *end++ = '\n';
+    cli_session_send(head, (size_t) (end - head));
+
+    CLI_Machine_s.rd = (CLI_Machine_s.rd + 1U == MACHINE_SLOTS) ? 0 : CLI_Machine_s.rd + 1U;
+
+    if (CLI_Machine_s.stop) {
+        CLI_Machine_s.stop = false;
+        CLI_Machine_s.active = false;
+        CLI_SetWrite(NULL);
+        CLI_PRINTF("%s", STRING_TERM_ARROW);
+    }
+}
+
+uint32_t cli_machine_get_ram_size(void)
+{
+    return sizeof(CLI_Machine_s);
+}
+
+#else
+
+bool cli_machine_set(bool on)
+{
+    (void) on;
+    return false;
+}
+
+bool cli_machine_is_active(void)
+{
+    return false;
+}
+
+void cli_machine_capture(bool on)
+{
+    (void) on;
+}
+
+bool cli_machine_put_char(char ch)
+{
+    (void) ch;
+    return false;
+}
+
+const char* cli_machine_begin(void)
+{
+    return NULL;
+}
+
+void cli_machine_end(uint8_t status)
+{
+    (void) status;
+}
+
+uint32_t cli_machine_get_ram_size(void)
+{
+    return 0;
+}
+
+#endif
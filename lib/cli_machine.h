@@ -0,0 +1,76 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_MACHINE_H_
+#define _CLI_MACHINE_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Machine text mode for scripts, "machine on" / "machine off": no echo, no
+ * prompt, one reply line for every request line, so requests can be pipelined.
+ *
+ *   request: [#<tag> ]<command string>
+ *   reply:   #<tag> <status> <payload>
+ *
+ * Tag is up to CLI_MACHINE_TAG_SIZE chars without spaces, empty tag for request
+ * without tag. Status is decimal CLI_Result_t. Payload is output of command
+ * without leading and trailing new lines, '\n' is written as "\n", '\' as "\\",
+ * '\r' is dropped, payload cut to CLI_MACHINE_REPLY_SIZE ends with "\+".
+ * Up to CLI_MACHINE_QUEUE_SIZE received lines wait for execute, line received
+ * while queue is full gets CLI_Err reply with payload "busy". Resumable command
+ * runs one step per cli_loop_service, next request waits for its reply. Output
+ * of jobs between requests and between steps is dropped.
+ */
+
+/**
+ * @brief Switch mode of current session, off takes effect after reply of current request
+ * @return false - other session is in machine mode
+ * */
+bool cli_machine_set(bool on);
+
+/** @brief Machine mode is active, input chars go to cli_machine_put_char */
+bool cli_machine_is_active(void);
+
+/**
+ * @brief Put received char, '\r' or '\n' ends line
+ * @return true - line is queued
+ * */
+bool cli_machine_put_char(char ch);
+
+/**
+ * @brief Take next queued request, output is captured to reply until cli_machine_end
+ * @return command string without tag, NULL - no request
+ * */
+const char* cli_machine_begin(void);
+
+/** @brief Output of command goes to reply, off between steps of resumable command */
+void cli_machine_capture(bool on);
+
+/** @brief Send reply of request taken by cli_machine_begin */
+void cli_machine_end(uint8_t status);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_machine_get_ram_size(void);
+
+#endif // _CLI_MACHINE_H_
@@ -0,0 +1,267 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#include "cli_mem.h"
+#include "cli_io.h"
+
+#if (CLI_MEM_EN == 1)
+
+#define MEM_LINE_BYTES          (16U)                                   // bytes per dump line
+#define MEM_LINE_MAX            (2U + 8U + 1U + MEM_LINE_BYTES * 3U + 3U + MEM_LINE_BYTES + 1U)   // "\r\nAAAAAAAA:" + " XX" * 16 + "  |" + ascii + "|"
+
+/** @brief Two hex digits for every byte value */
+static const char _hexByte[512] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+#if (CLI_MEM_SIM_EN == 1)
+static uint8_t _simMem[CLI_MEM_SIM_SIZE] __attribute__((aligned(4)));   // simulated memory region
+#endif
+
+/**
+ * @brief Translate address of len bytes
+ * @return pointer for access or NULL
+ * */
+static volatile void* _mem_ptr(uintptr_t addr, uint32_t len)
+{
+#if (CLI_MEM_SIM_EN == 1)
+    if ((addr < CLI_MEM_SIM_BASE) || (addr - CLI_MEM_SIM_BASE > CLI_MEM_SIM_SIZE) ||
+        (len > CLI_MEM_SIM_SIZE - (addr - CLI_MEM_SIM_BASE)))
+        return NULL;
+
+    return &_simMem[addr - CLI_MEM_SIM_BASE];
+#else
+    (void) len;
+    return (volatile void*) addr;
+#endif
+}
+
+static inline bool _valid_width(uintptr_t addr, uint8_t width)
+{
+    return ((width == 1) || (width == 2) || (width == 4)) && ((addr & (width - 1U)) == 0);
+}
+
+static inline uint32_t _load(volatile void* p, uint8_t width)
+{
+    if (width == 4)
+        return *(volatile uint32_t*) p;
+    if (width == 2)
+        return *(volatile uint16_t*) p;
+    return *(volatile uint8_t*) p;
+}
+
+/** @brief Write byte as two hex digits */
+static inline char* _put_hex8(char* out, uint8_t v)
+{
+    out[0] = _hexByte[v * 2U];
+    out[1] = _hexByte[v * 2U + 1U];
+    return out + 2;
+}
+
+/** @brief Write value as width * 2 hex digits */
+static char* _put_hex(char* out, uint32_t v, uint8_t width)
+{
+    switch (width) {
+        case 4:
+            out = _put_hex8(out, (uint8_t) (v >> 24));
+            out = _put_hex8(out, (uint8_t) (v >> 16));
+            /* fall through */
+        case 2:
+            out = _put_hex8(out, (uint8_t) (v >> 8));
+            /* fall through */
+        default:
+            out = _put_hex8(out, (uint8_t) v);
+            break;
+    }
+    return out;
+}
+
+bool cli_mem_read(uintptr_t addr, uint8_t width, uint32_t* value)
+{
+    volatile void* p = _mem_ptr(addr, width);
+
+    if ((p == NULL) || !_valid_width(addr, width))
+        return false;
+
+    *value = _load(p, width);
+    return true;
+}
+
+bool cli_mem_write(uintptr_t addr, uint8_t width, uint32_t value)
+{
+    volatile void* p = _mem_ptr(addr, width);
+
+    if ((p == NULL) || !_valid_width(addr, width))
+        return false;
+
+    if (width == 4)
+        *(volatile uint32_t*) p = value;
+    else if (width == 2)
+        *(volatile uint16_t*) p = (uint16_t) value;
+    else
+        *(volatile uint8_t*) p = (uint8_t) value;
+
+    return true;
+}
+
+CLI_Result_t cli_mem_dump(uintptr_t addr, uint32_t count, uint8_t width)
+{
+    volatile uint8_t* p;
+    char* out = output_print_buffer;
+    char* const end = output_print_buffer + sizeof(output_print_buffer) - 1U;
+    uint8_t ascii[MEM_LINE_BYTES];
+
+    if (!_valid_width(addr, width) || (count > UINT32_MAX / width))
+        return CLI_ArgErr;
+
+    p = (volatile uint8_t*) _mem_ptr(addr, count * width);
+    if (p == NULL)
+        return CLI_ArgErr;
+
+    while (count > 0) {
+        uint32_t units = MEM_LINE_BYTES / width;
+        if (units > count)
+            units = count;
+
+        // flush whole lines, output path sees a few large strings
+        if (out + MEM_LINE_MAX > end) {
+            *out = '\0';
+            CLI_PrintStr(output_print_buffer);
+            out = output_print_buffer;
+
+            if (cli_get_int_state())
+                return CLI_WorkInt;
+        }
+
+        *out++ = '\r';
+        *out++ = '\n';
+        out = _put_hex(out, (uint32_t) addr, 4);
+        *out++ = ':';
+
+        for (uint32_t i = 0; i < units; i++) {
+            uint32_t v = _load(p + i * width, width);
+            // ascii column in memory order
+            for (uint8_t b = 0; b < width; b++)
+                ascii[i * width + b] = ((const uint8_t*) &v)[b];
+
+            *out++ = ' ';
+            out = _put_hex(out, v, width);
+        }
+
+        // align ascii column of last short line
+        for (uint32_t i = units; i < MEM_LINE_BYTES / width; i++) {
+            for (uint8_t b = 0; b <= width * 2U; b++)
+                *out++ = ' ';
+        }
+
+        *out++ = ' ';
+        *out++ = ' ';
+        *out++ = '|';
+        for (uint32_t i = 0; i < units * width; i++)
+            *out++ = ((ascii[i] >= 0x20) && (ascii[i] < 0x7F)) ? (char) ascii[i] : '.';
+        *out++ = '|';
+
+        p += units * width;
+        addr += units * width;
+        count -= units;
+    }
+
+    *out = '\0';
+    CLI_PrintStr(output_print_buffer);
+
+    return CLI_OK;
+}
+
+uint32_t cli_mem_get_ram_size(void)
+{
+#if (CLI_MEM_SIM_EN == 1)
+    return sizeof(_simMem);
+#else
+    return 0;
+#endif
+}
+
+#endif // CLI_MEM_EN == 1
+
+
+#if (CLI_STACK_PAINT_EN == 1)
+
+#define STACK_PAINT_MAGIC       (0xA5U)                                 // pattern of unused stack
+#define STACK_PAINT_WORD        (0xA5A5A5A5UL)
+#define STACK_PAINT_WORDS       (CLI_STACK_PAINT_SIZE / sizeof(uint32_t))
+
+// painted region, kept as addresses: frame of cli_mem_stack_paint is gone after return
+static uintptr_t _stackLow;
+static uintptr_t _stackHigh;
+static bool _stackArmed;
+
+void cli_mem_stack_arm(bool on)
+{
+    _stackArmed = on;
+}
+
+bool cli_mem_stack_is_armed(void)
+{
+    return _stackArmed;
+}
+
+__attribute__((noinline))
+void cli_mem_stack_paint(void)
+{
+    volatile uint32_t area[STACK_PAINT_WORDS];
+
+    for (uint32_t i = 0; i < STACK_PAINT_WORDS; i++)
+        area[i] = STACK_PAINT_WORD;
+
+    _stackLow = (uintptr_t) &area[0];
+    _stackHigh = (uintptr_t) &area[STACK_PAINT_WORDS];
+}
+
+// painted region is below stack pointer, host sanitizer reports reads of dead frames
+#if defined(__GNUC__)
+__attribute__((noinline, no_sanitize_address))
+#endif
+uint32_t cli_mem_stack_used(void)
+{
+    const volatile uint32_t* w = (const volatile uint32_t*) _stackLow;
+
+    if (w == NULL)
+        return 0;
+
+    // stack grows down, first overwritten byte from the bottom is high-water mark
+    while (((uintptr_t) w < _stackHigh) && (*w == STACK_PAINT_WORD))
+        w++;
+
+    const volatile uint8_t* p = (const volatile uint8_t*) w;
+    while (((uintptr_t) p < _stackHigh) && (*p == STACK_PAINT_MAGIC))
+        p++;
+
+    return (uint32_t) (_stackHigh - (uintptr_t) p);
+}
+
+#endif // CLI_STACK_PAINT_EN == 1
@@ -0,0 +1,85 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#ifndef _CLI_MEM_H_
+#define _CLI_MEM_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Memory access for "md", "mr" and "mw" commands. Every unit is read and written
+ * with one access of the selected width (1, 2 or 4 bytes), so peripheral registers
+ * can be dumped safely. With CLI_MEM_SIM_EN addresses are mapped on a static region
+ * CLI_MEM_SIM_BASE..CLI_MEM_SIM_BASE + CLI_MEM_SIM_SIZE (host port).
+ */
+
+/**
+ * @brief Read one unit
+ * @param addr - address aligned to width
+ * @param width - 1, 2 or 4 bytes
+ * @param value - output value
+ * @return false if address is not valid
+ * */
+bool cli_mem_read(uintptr_t addr, uint8_t width, uint32_t* value);
+
+/**
+ * @brief Write one unit
+ * @param addr - address aligned to width
+ * @param width - 1, 2 or 4 bytes
+ * @param value - value, truncated to width
+ * @return false if address is not valid
+ * */
+bool cli_mem_write(uintptr_t addr, uint8_t width, uint32_t value);
+
+/**
+ * @brief Print hex dump with ASCII column, 16 bytes per line
+ * @param addr - start address aligned to width
+ * @param count - number of units
+ * @param width - 1, 2 or 4 bytes
+ * @return CLI_OK, CLI_ArgErr - bad address, CLI_WorkInt - aborted by Ctrl+C
+ * */
+CLI_Result_t cli_mem_dump(uintptr_t addr, uint32_t count, uint8_t width);
+
+/** @brief Size of static state in bytes (simulated region), "mem" command */
+uint32_t cli_mem_get_ram_size(void);
+
+/** @brief Arm stack high-water sampling of commands, "mem stack on|off" */
+void cli_mem_stack_arm(bool on);
+
+/** @brief Stack high-water sampling is armed */
+bool cli_mem_stack_is_armed(void);
+
+/**
+ * @brief Paint CLI_STACK_PAINT_SIZE bytes of free stack below caller with pattern
+ * @note call right before measured function, from the same frame as cli_mem_stack_used
+ * */
+void cli_mem_stack_paint(void);
+
+/**
+ * @brief Stack used since cli_mem_stack_paint in bytes, from frame of caller
+ * @return high-water mark, CLI_STACK_PAINT_SIZE - painted region exhausted
+ * */
+uint32_t cli_mem_stack_used(void);
+
+#endif // _CLI_MEM_H_
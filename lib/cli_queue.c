@@ -58,7 +58,7 @@ bool cli_queue_push(QueueObj* qdObj, const void* value)
     {
         if ((qd->mode & QUEUE_FORCED_PUSH_POP_Msk) != 0)
         {
-            memcpy(qd->ptrObj, qd->ptrObj + qd->sizeObj, qd->sizeObj * (qd->size - 1));
+            memmove(qd->ptrObj, qd->ptrObj + qd->sizeObj, qd->sizeObj * (qd->size - 1));
             memcpy(qd->ptrObj + qd->sizeObj * (qd->_cntr - 1), value, qd->sizeObj);
             qd->_cntr = qd->size;
         }
@@ -82,10 +82,7 @@ bool cli_queue_pop(QueueObj* qdObj, void* value)
         return false;
 
     memcpy((uint8_t*)value, qd->ptrObj, qd->sizeObj);
-    for(uint8_t i = 0; i < qd->_cntr; i++)
-    {
-        memcpy((uint8_t*)(qd->ptrObj + qd->sizeObj * i), (uint8_t*)(qd->ptrObj + qd->sizeObj * (i+1)), qd->sizeObj);
-    }
+    memmove(qd->ptrObj, qd->ptrObj + qd->sizeObj, qd->sizeObj * (qd->_cntr - 1));
 
     qd->_cntr--;
     return true;
@@ -0,0 +1,177 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#include "cli_rec.h"
+#include "tinystring.h"
+
+#if (CLI_REC_EN == 1)
+
+#include "cli_time.h"
+
+#define _VARINT_MAX             (5)                         // bytes of uint32_t varint
+
+static struct{
+    CLI_RecWrite_t write;                   // NULL - recording stopped
+    uint64_t lastTick;                      // tick of previous run
+    uint64_t runTick;                       // tick of current run
+    uint8_t runLen;                         // chars in current run
+    char run[CLI_REC_RUN_SIZE];
+}CLI_Rec_s;
+
+static uint8_t _put_varint(uint8_t* buf, uint32_t value)
+{
+    uint8_t len = 0;
+
+    while (value >= 0x80) {
+        buf[len++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    buf[len++] = (uint8_t) value;
+
+    return len;
+}
+
+static void _write_run_head(uint8_t runLen)
+{
+    uint8_t head[2 * _VARINT_MAX];
+    uint64_t dt = CLI_Rec_s.runTick - CLI_Rec_s.lastTick;
+    uint8_t len;
+
+    len = _put_varint(head, (dt > UINT32_MAX) ? UINT32_MAX : (uint32_t) dt);
+    len += _put_varint(&head[len], runLen);
+    CLI_Rec_s.write(head, len);
+}
+
+static void _flush_run(void)
+{
+    if (CLI_Rec_s.runLen == 0)
+        return;
+
+    _write_run_head(CLI_Rec_s.runLen);
+    CLI_Rec_s.write((const uint8_t*) CLI_Rec_s.run, CLI_Rec_s.runLen);
+
+    CLI_Rec_s.lastTick = CLI_Rec_s.runTick;
+    CLI_Rec_s.runLen = 0;
+}
+
+void cli_rec_start(CLI_RecWrite_t write)
+{
+    uint8_t head[4 + 1 + _VARINT_MAX];
+    uint8_t len = 4;
+
+    cli_memcpy(head, CLI_REC_MAGIC, 4);
+    head[len++] = CLI_REC_VERSION;
+    len += _put_varint(&head[len], CLI_TICK_FREQ_HZ);
+    write(head, len);
+
+    CLI_Rec_s.lastTick = cli_time_get_tick();
+    CLI_Rec_s.runLen = 0;
+    CLI_Rec_s.write = write;
+}
+
+void cli_rec_stop(void)
+{
+    if (CLI_Rec_s.write == NULL)
+        return;
+
+    _flush_run();
+
+    // end mark: run without chars, replay keeps ticks of the session after last char
+    CLI_Rec_s.runTick = cli_time_get_tick();
+    _write_run_head(0);
+    CLI_Rec_s.write = NULL;
+}
+
+void cli_rec_put(char ch)
+{
+    uint64_t tick;
+
+    if (CLI_Rec_s.write == NULL)
+        return;
+
+    tick = cli_time_get_tick();
+    if ((CLI_Rec_s.runLen == CLI_REC_RUN_SIZE) || ((CLI_Rec_s.runLen != 0) && (tick != CLI_Rec_s.runTick)))
+        _flush_run();
+
+    if (CLI_Rec_s.runLen == 0)
+        CLI_Rec_s.runTick = tick;
+    CLI_Rec_s.run[CLI_Rec_s.runLen++] = ch;
+}
+
+uint32_t cli_rec_get_ram_size(void)
+{
+    return sizeof(CLI_Rec_s);
+}
+
+#endif // CLI_REC_EN == 1
+
+
+// reader does not depend on CLI_REC_EN, replay tools use it on host
+
+static bool _get_varint(CLI_RecReader_t* rd, uint32_t* value)
+{
+    uint32_t v = 0;
+
+    for (uint8_t shift = 0; shift < 7 * 5; shift += 7) {
+        if (rd->pos >= rd->size)
+            return false;
+
+        uint8_t b = rd->data[rd->pos++];
+        v |= (uint32_t) (b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            *value = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool cli_rec_reader_init(CLI_RecReader_t* rd, const uint8_t* data, size_t size)
+{
+    rd->data = data;
+    rd->size = size;
+    rd->pos = 5;
+    rd->runLeft = 0;
+
+    if ((size < 5) || !_strncmp((const char*) data, CLI_REC_MAGIC, 4) || (data[4] != CLI_REC_VERSION))
+        return false;
+
+    return _get_varint(rd, &rd->freqHz) && (rd->freqHz != 0);
+}
+
+bool cli_rec_next(CLI_RecReader_t* rd, uint32_t* dtTicks, char* ch)
+{
+    *dtTicks = 0;
+
+    if (rd->runLeft == 0) {
+        // end mark has length 0, its ticks are left in dtTicks
+        if (!_get_varint(rd, dtTicks) || !_get_varint(rd, &rd->runLeft) || (rd->runLeft == 0))
+            return false;
+    }
+
+    if (rd->pos >= rd->size)
+        return false;
+
+    *ch = (char) rd->data[rd->pos++];
+    rd->runLeft--;
+
+    return true;
+}
@@ -0,0 +1,84 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+#ifndef _CLI_REC_H_
+#define _CLI_REC_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Record of input stream of cli_append_char with tick timestamps.
+ *
+ * Format (little endian varints, 7 bits per byte):
+ *   header: "CLIR", version, varint CLI_TICK_FREQ_HZ of recorder
+ *   runs:   varint ticks since previous run, varint length, length raw chars
+ *   end:    varint ticks since previous run, 0 (written by cli_rec_stop)
+ * Chars of one tick (paste, escape sequence) are stored in one run, so typed
+ * input costs ~3 bytes per char and pasted input ~1 byte per char.
+ */
+
+#define CLI_REC_MAGIC           ("CLIR")
+#define CLI_REC_VERSION         (1)
+
+/** @brief Output of recorder: file, flash, UART */
+typedef void (*CLI_RecWrite_t)(const uint8_t* data, size_t len);
+
+/** @brief Reader of record in memory */
+typedef struct{
+    const uint8_t* data;            // record
+    size_t size;                    // size of record
+    size_t pos;                     // next byte
+    uint32_t runLeft;               // chars left in current run
+    uint32_t freqHz;                // tick frequency of recorder
+}CLI_RecReader_t;
+
+/**
+ * @brief Start recording, writes header
+ * @param write - output of record
+ * */
+void cli_rec_start(CLI_RecWrite_t write);
+
+/** @brief Flush last run and stop recording */
+void cli_rec_stop(void);
+
+/** @brief Record char, called from cli_append_char */
+void cli_rec_put(char ch);
+
+/**
+ * @brief Init reader and check header
+ * @return false - not a record or unsupported version
+ * */
+bool cli_rec_reader_init(CLI_RecReader_t* rd, const uint8_t* data, size_t size);
+
+/**
+ * @brief Get next recorded char
+ * @param dtTicks - ticks of recorder since previous char, at the end: ticks of
+ *                  session after last char (0 if record has no end mark)
+ * @return false - end of record
+ * */
+bool cli_rec_next(CLI_RecReader_t* rd, uint32_t* dtTicks, char* ch);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_rec_get_ram_size(void);
+
+#endif // _CLI_REC_H_
@@ -0,0 +1,540 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_rpc.h"
+#include "cli_io.h"
+
+#define RPC_ENCODED_SIZE        (CLI_RPC_FRAME_SIZE + CLI_RPC_FRAME_SIZE / 254U + 2U)   // COBS overhead and 0x00
+#define RPC_REQ_HEAD            (3U)                    // seq, command ID
+#define RPC_RESP_HEAD           (2U)                    // seq, status
+#define RPC_CRC_SIZE            (2U)
+#define RPC_NUM_SIZE            (11U)                   // "-2147483648"
+
+static const uint16_t _crcNibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t cli_rpc_crc16(const uint8_t* data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc = (uint16_t) (crc << 4) ^ _crcNibble[(crc >> 12) ^ (*data >> 4)];
+        crc = (uint16_t) (crc << 4) ^ _crcNibble[(crc >> 12) ^ (*data & 0x0F)];
+        data++;
+    }
+
+    return crc;
+}
+
+size_t cli_rpc_cobs_encode(const uint8_t* src, size_t len, uint8_t* dst)
+{
+    size_t code = 0;                                    // position of code byte of current block
+    size_t out = 1;
+    uint8_t run = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] != 0) {
+            dst[out++] = src[i];
+            run++;
+        }
+        if ((src[i] == 0) || (run == 0xFF)) {
+            dst[code] = run;
+            code = out++;
+            run = 1;
+        }
+    }
+    dst[code] = run;
+
+    return out;
+}
+
+size_t cli_rpc_cobs_decode(const uint8_t* src, size_t len, uint8_t* dst)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < len) {
+        uint8_t code = src[in++];
+
+        if ((code == 0) || (in + code - 1U > len))
+            return 0;
+
+        for (uint8_t i = 1; i < code; i++)
+            dst[out++] = src[in++];
+
+        if ((code != 0xFF) && (in < len))
+            dst[out++] = 0;
+    }
+
+    return out;
+}
+
+#if (CLI_RPC_EN == 1)
+
+/** @brief RPC mode */
+static struct{
+    uint8_t frame[RPC_ENCODED_SIZE];                    // received request (decoded in place), encoded response
+    uint8_t out[CLI_RPC_FRAME_SIZE];                    // response
+    char line[CLI_CMD_BUF_SIZE + 1];                    // command string of request
+    uint8_t state[CLI_JOB_STATE_SIZE] __attribute__((aligned(8)));  // state of resumable command
+    uint16_t frameLen;                                  // received bytes of frame
+    uint16_t outLen;                                    // bytes of response
+    uint16_t lastItem;                                  // position of last typed value, 0 - none
+    uint16_t step;                                      // next step of running command
+    uint8_t enterPos;                                   // matched chars of CLI_RPC_ENTER_SEQ
+    CLI_Session_t* owner;                               // session in RPC mode
+    bool active;                                        // RPC mode
+    bool ready;                                         // request received, response not sent
+    bool running;                                       // command of request runs, one step per cli_rpc_service
+    bool skip;                                          // drop bytes until 0x00
+    bool capture;                                       // output of command goes to response
+    bool truncated;                                     // output longer than response
+    bool typed;                                         // response holds typed values
+}CLI_Rpc_s;
+
+/** @brief Output of CLI while RPC mode is active, text after typed values is dropped */
+static void _write(const char* str, size_t len)
+{
+    if (!CLI_Rpc_s.capture || CLI_Rpc_s.typed)
+        return;
+
+    size_t space = CLI_RPC_FRAME_SIZE - RPC_CRC_SIZE - CLI_Rpc_s.outLen;
+    if (len > space) {
+        len = space;
+        CLI_Rpc_s.truncated = true;
+    }
+
+    for (size_t i = 0; i < len; i++)
+        CLI_Rpc_s.out[CLI_Rpc_s.outLen++] = (uint8_t) str[i];
+}
+
+/** @brief Add CRC, encode and send response of len bytes */
+static void _send(uint16_t len)
+{
+    uint16_t crc = cli_rpc_crc16(CLI_Rpc_s.out, len);
+
+    CLI_Rpc_s.out[len++] = (uint8_t) crc;
+    CLI_Rpc_s.out[len++] = (uint8_t) (crc >> 8);
+
+    size_t n = cli_rpc_cobs_encode(CLI_Rpc_s.out, len, CLI_Rpc_s.frame);
+    CLI_Rpc_s.frame[n++] = 0;
+    cli_session_send((const char*) CLI_Rpc_s.frame, n);
+}
+
+/** @brief Write number in base 10 or 16 */
+static uint8_t _num_to_str(uint32_t value, bool negative, uint8_t base, char* buf)
+{
+    char tmp[RPC_NUM_SIZE];
+    uint8_t n = 0;
+    uint8_t len = 0;
+
+    do {
+        uint8_t digit = (uint8_t) (value % base);
+        tmp[n++] = (char) ((digit < 10) ? ('0' + digit) : ('A' + digit - 10));
+        value /= base;
+    } while (value != 0);
+
+    if (negative)
+        buf[len++] = '-';
+    while (n > 0)
+        buf[len++] = tmp[--n];
+
+    return len;
+}
+
+/** @brief Append word to command string */
+static bool _add_word(uint16_t* pos, const char* word, uint16_t len)
+{
+    if (*pos + 1U + len > CLI_CMD_BUF_SIZE)
+        return false;
+
+    CLI_Rpc_s.line[(*pos)++] = ' ';
+    for (uint16_t i = 0; i < len; i++)
+        CLI_Rpc_s.line[(*pos)++] = word[i];
+
+    return true;
+}
+
+/**
+ * @brief Command string of request
+ * @param args - typed arguments
+ * @return CLI_OK, CLI_NotFound - no command ID, CLI_ArgErr - string is too long,
+ *         CLI_RPC_BAD_FRAME - bad argument
+ * */
+static uint8_t _build_line(uint16_t id, const uint8_t* args, size_t len)
+{
+    const char* name = cli_get_cmd_name(id);
+
+    if (name == NULL)
+        return CLI_NotFound;
+
+    uint16_t pos = (uint16_t) _strlen(name);
+    cli_memcpy(CLI_Rpc_s.line, name, pos);
+
+    size_t i = 0;
+    while (i < len) {
+        char num[RPC_NUM_SIZE];
+        uint8_t type = args[i++];
+        bool added;
+
+        if (type == CLI_RPC_ARG_STR) {
+            if ((i >= len) || (args[i] > len - i - 1))
+                return CLI_RPC_BAD_FRAME;
+
+            uint8_t n = args[i++];
+            added = _add_word(&pos, (const char*) &args[i], n);
+            i += n;
+        } else {
+            if (len - i < 4)
+                return CLI_RPC_BAD_FRAME;
+
+            uint32_t v = (uint32_t) args[i] | ((uint32_t) args[i + 1] << 8) |
+                         ((uint32_t) args[i + 2] << 16) | ((uint32_t) args[i + 3] << 24);
+            i += 4;
+
+            uint8_t n;
+            if (type == CLI_RPC_ARG_U32)
+                n = _num_to_str(v, false, 10, num);
+            else if (type == CLI_RPC_ARG_I32)
+                n = ((int32_t) v < 0) ? _num_to_str(0U - v, true, 10, num) : _num_to_str(v, false, 10, num);
+            else if (type == CLI_RPC_ARG_HEX)
+                n = _num_to_str(v, false, 16, num);
+            else
+                return CLI_RPC_BAD_FRAME;
+
+            added = _add_word(&pos, num, n);
+        }
+
+        if (!added)
+            return CLI_ArgErr;
+    }
+
+    CLI_Rpc_s.line[pos] = '\0';
+    return CLI_OK;
+}
+
+/** @brief One step of command, output goes to response, output of jobs between steps is dropped */
+static CLI_Result_t _step(void)
+{
+    CLI_Rpc_s.capture = true;
+    CLI_Result_t result = cli_execute_step(CLI_Rpc_s.line, CLI_Rpc_s.state, CLI_Rpc_s.step);
+    CLI_Rpc_s.capture = false;
+
+    if (CLI_Rpc_s.step < UINT16_MAX)
+        CLI_Rpc_s.step++;
+
+    return result;
+}
+
+/** @brief Append typed value, consecutive bytes values are merged up to 255 bytes */
+static bool _put_item(uint8_t type, const uint8_t* data, uint8_t len)
+{
+    if (!cli_rpc_in_request())
+        return false;
+
+    // text written before the first typed value is dropped
+    if (!CLI_Rpc_s.typed) {
+        CLI_Rpc_s.typed = true;
+        CLI_Rpc_s.outLen = RPC_RESP_HEAD;
+        CLI_Rpc_s.lastItem = 0;
+    }
+
+    uint16_t space = CLI_RPC_FRAME_SIZE - RPC_CRC_SIZE - CLI_Rpc_s.outLen;
+    uint8_t* out = &CLI_Rpc_s.out[CLI_Rpc_s.outLen];
+    uint8_t* last = &CLI_Rpc_s.out[CLI_Rpc_s.lastItem];
+
+    if ((type == CLI_RPC_ARG_BYTES) && (CLI_Rpc_s.lastItem != 0) && (last[0] == CLI_RPC_ARG_BYTES) &&
+        (last[1] + len <= UINT8_MAX)) {
+        if (len > space) {
+            CLI_Rpc_s.truncated = true;
+            return false;
+        }
+        last[1] += len;
+    } else {
+        uint8_t head = (type == CLI_RPC_ARG_BYTES) ? 2U : 1U;
+
+        if (head + len > space) {
+            CLI_Rpc_s.truncated = true;
+            return false;
+        }
+        CLI_Rpc_s.lastItem = CLI_Rpc_s.outLen;
+        *out++ = type;
+        if (type == CLI_RPC_ARG_BYTES)
+            *out++ = len;
+        CLI_Rpc_s.outLen += head;
+    }
+
+    cli_memcpy(out, data, len);
+    CLI_Rpc_s.outLen += len;
+
+    return true;
+}
+
+bool cli_rpc_in_request(void)
+{
+    return CLI_Rpc_s.capture && cli_rpc_is_active();
+}
+
+bool cli_rpc_put_u32(CLI_RpcArg_t type, uint32_t value)
+{
+    uint8_t le[4] = {(uint8_t) value, (uint8_t) (value >> 8), (uint8_t) (value >> 16), (uint8_t) (value >> 24)};
+
+    if ((type != CLI_RPC_ARG_U32) && (type != CLI_RPC_ARG_I32) && (type != CLI_RPC_ARG_HEX))
+        return false;
+
+    return _put_item((uint8_t) type, le, sizeof(le));
+}
+
+bool cli_rpc_put_bytes(const void* data, uint8_t len)
+{
+    return _put_item(CLI_RPC_ARG_BYTES, (const uint8_t*) data, len);
+}
+
+/** @brief Names of commands, each ends with '\0' */
+static uint8_t _list(void)
+{
+    const char* name;
+
+    CLI_Rpc_s.capture = true;
+    for (uint16_t id = 0; (name = cli_get_cmd_name(id)) != NULL; id++)
+        _write(name, _strlen(name) + 1);
+    CLI_Rpc_s.capture = false;
+
+    return CLI_OK;
+}
+
+bool cli_rpc_match_enter(char ch)
+{
+    static const char seq[] = CLI_RPC_ENTER_SEQ;
+
+    if (ch == seq[CLI_Rpc_s.enterPos])
+        CLI_Rpc_s.enterPos++;
+    else
+        CLI_Rpc_s.enterPos = (ch == seq[0]) ? 1 : 0;
+
+    if (seq[CLI_Rpc_s.enterPos] != '\0')
+        return false;
+
+    CLI_Rpc_s.enterPos = 0;
+    return true;
+}
+
+bool cli_rpc_start(void)
+{
+    uint16_t count = cli_get_cmd_count();
+
+    // one session in RPC mode
+    if (CLI_Rpc_s.active)
+        return false;
+
+    CLI_Rpc_s.owner = cli_session_get_current();
+    CLI_Rpc_s.active = true;
+    CLI_Rpc_s.ready = false;
+    CLI_Rpc_s.running = false;
+    CLI_Rpc_s.skip = false;
+    CLI_Rpc_s.frameLen = 0;
+    CLI_SetWrite(_write);
+
+    // delimiter ends text output in decoder of host
+    cli_session_send("\0", 1);
+
+    CLI_Rpc_s.out[0] = 0;
+    CLI_Rpc_s.out[1] = CLI_OK;
+    CLI_Rpc_s.out[2] = CLI_RPC_VERSION;
+    CLI_Rpc_s.out[3] = (uint8_t) count;
+    CLI_Rpc_s.out[4] = (uint8_t) (count >> 8);
+    _send(5);
+
+    return true;
+}
+
+bool cli_rpc_is_active(void)
+{
+    return CLI_Rpc_s.active && (CLI_Rpc_s.owner == cli_session_get_current());
+}
+
+bool cli_rpc_put_byte(uint8_t byte)
+{
+    // one request in flight: next frame is dropped until end of it
+    if (CLI_Rpc_s.ready) {
+        CLI_Rpc_s.skip = (byte != 0);
+        return false;
+    }
+
+    if (byte == 0) {
+        bool frame = !CLI_Rpc_s.skip && (CLI_Rpc_s.frameLen != 0);
+
+        CLI_Rpc_s.skip = false;
+        if (frame)
+            CLI_Rpc_s.ready = true;
+        else
+            CLI_Rpc_s.frameLen = 0;
+
+        return frame;
+    }
+
+    if (CLI_Rpc_s.skip)
+        return false;
+
+    // longer than CLI_RPC_FRAME_SIZE is dropped
+    if (CLI_Rpc_s.frameLen >= RPC_ENCODED_SIZE - 1U) {
+        CLI_Rpc_s.skip = true;
+        CLI_Rpc_s.frameLen = 0;
+        return false;
+    }
+
+    CLI_Rpc_s.frame[CLI_Rpc_s.frameLen++] = byte;
+    return false;
+}
+
+/** @brief Send response of request and wait for next one */
+static void _respond(uint8_t status, bool exit)
+{
+    CLI_Rpc_s.out[1] = status | (CLI_Rpc_s.truncated ? CLI_RPC_TRUNCATED : 0) | (CLI_Rpc_s.typed ? CLI_RPC_TYPED : 0);
+    _send(CLI_Rpc_s.outLen);
+
+    CLI_Rpc_s.frameLen = 0;
+    CLI_Rpc_s.running = false;
+    CLI_Rpc_s.ready = false;
+
+    if (exit) {
+        CLI_Rpc_s.active = false;
+        CLI_SetWrite(NULL);
+        CLI_PRINTF("%s%s", STRING_TERM_ENTER, STRING_TERM_ARROW);
+    }
+}
+
+bool cli_rpc_service(void)
+{
+    // request is executed in session which received it
+    if (!CLI_Rpc_s.ready || !cli_rpc_is_active())
+        return false;
+
+    // resumable command: one step per call, other sessions and jobs run between steps
+    if (CLI_Rpc_s.running) {
+        CLI_Result_t result = _step();
+
+        if (result != CLI_Continue)
+            _respond((uint8_t) result, false);
+        return true;
+    }
+
+    uint8_t* req = CLI_Rpc_s.frame;
+    size_t len = cli_rpc_cobs_decode(req, CLI_Rpc_s.frameLen, req);
+    uint8_t status = CLI_RPC_BAD_FRAME;
+    bool exit = false;
+
+    CLI_Rpc_s.out[0] = (len != 0) ? req[0] : 0;
+    CLI_Rpc_s.outLen = RPC_RESP_HEAD;
+    CLI_Rpc_s.truncated = false;
+    CLI_Rpc_s.typed = false;
+
+    if ((len >= RPC_REQ_HEAD + RPC_CRC_SIZE) &&
+        (cli_rpc_crc16(req, len - RPC_CRC_SIZE) == (uint16_t) (req[len - 2] | (req[len - 1] << 8)))) {
+        uint16_t id = (uint16_t) (req[1] | (req[2] << 8));
+
+        if (id == CLI_RPC_ID_LIST) {
+            status = _list();
+        } else if (id == CLI_RPC_ID_EXIT) {
+            status = CLI_OK;
+            exit = true;
+        } else {
+            status = _build_line(id, &req[RPC_REQ_HEAD], len - RPC_REQ_HEAD - RPC_CRC_SIZE);
+            if (status == CLI_OK) {
+                cli_memset(CLI_Rpc_s.state, 0, CLI_JOB_STATE_SIZE);
+                CLI_Rpc_s.step = 0;
+
+                CLI_Result_t result = _step();
+                if (result == CLI_Continue) {
+                    CLI_Rpc_s.running = true;
+                    return true;
+                }
+                status = (uint8_t) result;
+            }
+        }
+    }
+
+    _respond(status, exit);
+
+    return true;
+}
+
+uint32_t cli_rpc_get_ram_size(void)
+{
+    return sizeof(CLI_Rpc_s);
+}
+
+#else
+
+bool cli_rpc_match_enter(char ch)
+{
+    (void) ch;
+    return false;
+}
+
+bool cli_rpc_start(void)
+{
+    return false;
+}
+
+bool cli_rpc_is_active(void)
+{
+    return false;
+}
+
+bool cli_rpc_put_byte(uint8_t byte)
+{
+    (void) byte;
+    return false;
+}
+
+bool cli_rpc_service(void)
+{
+    return false;
+}
+
+bool cli_rpc_in_request(void)
+{
+    return false;
+}
+
+bool cli_rpc_put_u32(CLI_RpcArg_t type, uint32_t value)
+{
+    (void) type;
+    (void) value;
+    return false;
+}
+
+bool cli_rpc_put_bytes(const void* data, uint8_t len)
+{
+    (void) data;
+    (void) len;
+    return false;
+}
+
+uint32_t cli_rpc_get_ram_size(void)
+{
+    return 0;
+}
+
+#endif
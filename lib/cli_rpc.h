@@ -0,0 +1,127 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_RPC_H_
+#define _CLI_RPC_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Binary RPC mode over the command table for test rigs: no echo, no prompt,
+ * one request in flight.
+ *
+ * Text mode switches to RPC mode on CLI_RPC_ENTER_SEQ, device answers with hello
+ * frame. Every frame is COBS encoded and ends with 0x00, raw frame ends with
+ * CRC-16/CCITT-FALSE (little endian) of previous bytes:
+ *   request:  seq, command ID (u16), typed arguments, crc
+ *   response: seq, status, output of command, crc
+ *   hello:    seq 0, status 0, CLI_RPC_VERSION, count of commands (u16), crc
+ * Command ID is index in order of cli_add_new_cmd ("help" - 0), arguments are
+ * rendered as words of command string, so handlers parse them as in text mode.
+ * Output of command is text, or typed values (CLI_RpcArg_t encoding) when the
+ * handler calls cli_rpc_put_u32 / cli_rpc_put_bytes ("mr", "md").
+ * Status is CLI_Result_t | CLI_RPC_TRUNCATED | CLI_RPC_TYPED or CLI_RPC_BAD_FRAME.
+ * Resumable command runs one step per cli_loop_service. Output of jobs between
+ * requests and between steps is dropped.
+ */
+
+#define CLI_RPC_ENTER_SEQ       ("\x1b[9~")         // switch from text mode (not a key of VT terminals)
+#define CLI_RPC_VERSION         (2)
+
+#define CLI_RPC_ID_LIST         (0xFFFFU)           // response: command names, each ends with '\0'
+#define CLI_RPC_ID_EXIT         (0xFFFEU)           // response, then switch to text mode
+
+#define CLI_RPC_TRUNCATED       (0x80U)             // status flag: output longer than frame
+#define CLI_RPC_TYPED           (0x40U)             // status flag: output is typed values
+#define CLI_RPC_BAD_FRAME       (0x3FU)             // status: CRC, length or argument error
+
+/** @brief Types of request arguments and typed values of response */
+typedef enum{
+    CLI_RPC_ARG_U32 = 1,                            // 4 bytes, decimal word
+    CLI_RPC_ARG_I32,                                // 4 bytes, signed decimal word
+    CLI_RPC_ARG_HEX,                                // 4 bytes, hex word (addresses of "md", "mw")
+    CLI_RPC_ARG_STR,                                // length (u8) and chars
+    CLI_RPC_ARG_BYTES                               // length (u8) and bytes, response only
+}CLI_RpcArg_t;
+
+/**
+ * @brief Track CLI_RPC_ENTER_SEQ in text input
+ * @return true - sequence received, call cli_rpc_start
+ * */
+bool cli_rpc_match_enter(char ch);
+
+/**
+ * @brief Switch current session to RPC mode and send hello frame
+ * @return false - other session is in RPC mode
+ * */
+bool cli_rpc_start(void);
+
+/** @brief RPC mode is active, input chars are bytes of frames */
+bool cli_rpc_is_active(void);
+
+/**
+ * @brief Put received byte
+ * @return true - frame received, executed by cli_rpc_service
+ * */
+bool cli_rpc_put_byte(uint8_t byte);
+
+/** @brief Execute received request (one step of resumable command) and send response, called from cli_loop_service */
+bool cli_rpc_service(void);
+
+/** @brief Current command runs for RPC request, handler may reply with typed values */
+bool cli_rpc_in_request(void);
+
+/**
+ * @brief Put typed value to response, text output of command is dropped
+ * @param type - CLI_RPC_ARG_U32, CLI_RPC_ARG_I32 or CLI_RPC_ARG_HEX
+ * @return false - not in RPC request or response is full (CLI_RPC_TRUNCATED)
+ * */
+bool cli_rpc_put_u32(CLI_RpcArg_t type, uint32_t value);
+
+/**
+ * @brief Put bytes to response, appended to previous bytes value up to 255 bytes
+ * @return false - not in RPC request or response is full (CLI_RPC_TRUNCATED)
+ * */
+bool cli_rpc_put_bytes(const void* data, uint8_t len);
+
+/**
+ * @brief COBS encode
+ * @param dst - output, len + len / 254 + 1 bytes, without 0x00 delimiter
+ * @return length of encoded data
+ * */
+size_t cli_rpc_cobs_encode(const uint8_t* src, size_t len, uint8_t* dst);
+
+/**
+ * @brief COBS decode, in place is allowed (dst == src)
+ * @return length of decoded data, 0 - bad encoding
+ * */
+size_t cli_rpc_cobs_decode(const uint8_t* src, size_t len, uint8_t* dst);
+
+/** @brief CRC-16/CCITT-FALSE */
+uint16_t cli_rpc_crc16(const uint8_t* data, size_t len);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_rpc_get_ram_size(void);
+
+#endif // _CLI_RPC_H_
@@ -0,0 +1,304 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_sched.h"
+#include "tinystring.h"
+
+#if (CLI_SCHED_EN == 1)
+
+#if ((CLI_SCHED_WHEEL_SIZE & (CLI_SCHED_WHEEL_SIZE - 1)) != 0)
+#error "CLI_SCHED_WHEEL_SIZE must be power of 2"
+#endif
+#if (CLI_SCHED_MAX_JOBS > 32)
+#error "CLI_SCHED_MAX_JOBS must be <= 32"
+#endif
+
+#define WHEEL_MSK           (CLI_SCHED_WHEEL_SIZE - 1)
+#define JOB_NONE            (-1)
+
+/** @brief Scheduled job */
+typedef struct{
+    char cmd[CLI_CMD_BUF_SIZE + 1];     // command string include arguments
+    uint32_t periodMs;                  // period between executions
+    uint32_t deadline;                  // time next execution in ms
+    uint32_t remaining;                 // remaining executions, 0 - until cancel
+    uint8_t state[CLI_JOB_STATE_SIZE] __attribute__((aligned(8)));  // state of background job
+    uint16_t step;                      // step of background job
+    int8_t next;                        // next job in the same wheel slot
+    bool isTask;                        // background job, not in wheel
+    bool active;
+}CLI_Job_t;
+
+static struct{
+    CLI_Job_t jobs[CLI_SCHED_MAX_JOBS];
+    int8_t wheel[CLI_SCHED_WHEEL_SIZE];     // head of job list for every slot
+    uint32_t lastMs;                        // time of last visited slot
+    uint32_t tasks;                         // mask of background jobs
+    uint32_t eager;                         // mask of jobs with period 0, not in wheel
+    uint8_t count;                          // count active jobs
+}CLI_Sched_s;
+
+static void _wheel_insert(uint8_t id)
+{
+    uint8_t slot = CLI_Sched_s.jobs[id].deadline & WHEEL_MSK;
+    CLI_Sched_s.jobs[id].next = CLI_Sched_s.wheel[slot];
+    CLI_Sched_s.wheel[slot] = (int8_t) id;
+}
+
+static void _wheel_remove(uint8_t id)
+{
+    int8_t* link = &CLI_Sched_s.wheel[CLI_Sched_s.jobs[id].deadline & WHEEL_MSK];
+
+    while (*link != JOB_NONE) {
+        if (*link == (int8_t) id) {
+            *link = CLI_Sched_s.jobs[id].next;
+            return;
+        }
+        link = &CLI_Sched_s.jobs[*link].next;
+    }
+}
+
+void cli_sched_init(void)
+{
+    for (uint8_t i = 0; i < CLI_SCHED_MAX_JOBS; i++)
+        CLI_Sched_s.jobs[i].active = false;
+
+    for (uint8_t i = 0; i < CLI_SCHED_WHEEL_SIZE; i++)
+        CLI_Sched_s.wheel[i] = JOB_NONE;
+
+    CLI_Sched_s.lastMs = CLI_GETMS();
+    CLI_Sched_s.tasks = 0;
+    CLI_Sched_s.eager = 0;
+    CLI_Sched_s.count = 0;
+}
+
+/** @brief Take free job slot and copy command, return slot or JOB_NONE */
+static int8_t _job_alloc(const char* cmd)
+{
+    uint32_t len = _strlen(cmd);
+
+    if ((len == 0) || (len > CLI_CMD_BUF_SIZE))
+        return JOB_NONE;
+
+    for (uint8_t i = 0; i < CLI_SCHED_MAX_JOBS; i++) {
+        CLI_Job_t* job = &CLI_Sched_s.jobs[i];
+
+        if (job->active)
+            continue;
+
+        cli_memcpy(job->cmd, cmd, len + 1);
+        job->active = true;
+        CLI_Sched_s.count++;
+
+        return (int8_t) i;
+    }
+
+    return JOB_NONE;
+}
+
+int8_t cli_sched_add(const char* cmd, uint32_t periodMs, uint32_t count)
+{
+    int8_t id = _job_alloc(cmd);
+
+    if (id == JOB_NONE)
+        return JOB_NONE;
+
+    CLI_Job_t* job = &CLI_Sched_s.jobs[id];
+    job->periodMs = periodMs;
+    job->remaining = count;
+    job->deadline = CLI_GETMS() + periodMs;
+    job->isTask = false;
+
+    // slot of current ms is already visited, job with period 0 runs on every service
+    if (periodMs == 0)
+        CLI_Sched_s.eager |= 1UL << id;
+    else
+        _wheel_insert(id);
+
+    return id;
+}
+
+int8_t cli_sched_add_task(const char* cmd)
+{
+    int8_t id = _job_alloc(cmd);
+
+    if (id == JOB_NONE)
+        return JOB_NONE;
+
+    CLI_Job_t* job = &CLI_Sched_s.jobs[id];
+    for (uint8_t i = 0; i < CLI_JOB_STATE_SIZE; i++)
+        job->state[i] = 0;
+    job->step = 0;
+    job->isTask = true;
+    CLI_Sched_s.tasks |= 1UL << id;
+
+    return id;
+}
+
+bool cli_sched_cancel(uint8_t id)
+{
+    if ((id >= CLI_SCHED_MAX_JOBS) || !CLI_Sched_s.jobs[id].active)
+        return false;
+
+    if (CLI_Sched_s.jobs[id].isTask)
+        CLI_Sched_s.tasks &= ~(1UL << id);
+    else if (CLI_Sched_s.eager & (1UL << id))
+        CLI_Sched_s.eager &= ~(1UL << id);
+    else
+        _wheel_remove(id);
+
+    CLI_Sched_s.jobs[id].active = false;
+    CLI_Sched_s.count--;
+
+    return true;
+}
+
+void cli_sched_cancel_all(bool tasks)
+{
+    for (uint8_t i = 0; i < CLI_SCHED_MAX_JOBS; i++)
+        if (tasks || !CLI_Sched_s.jobs[i].isTask)
+            cli_sched_cancel(i);
+}
+
+inline uint8_t cli_sched_count(void)
+{
+    return CLI_Sched_s.count;
+}
+
+/** @brief Execute one step of every background job, return count finished jobs */
+static uint8_t _tasks_service(void)
+{
+    uint8_t finished = 0;
+    uint32_t tasks = CLI_Sched_s.tasks;
+
+    for (uint8_t id = 0; tasks != 0; id++, tasks >>= 1) {
+        CLI_Job_t* job = &CLI_Sched_s.jobs[id];
+
+        if (!(tasks & 1UL) || !job->active)
+            continue;
+
+        CLI_Result_t result = cli_execute_step(job->cmd, job->state, job->step);
+
+        // job may be killed by own step
+        if (!job->active)
+            continue;
+
+        if (result == CLI_Continue) {
+            if (job->step < UINT16_MAX)
+                job->step++;
+            continue;
+        }
+
+        CLI_PRINTF("\r\n[%d] %s  %s", (int) id, (result == CLI_OK) ? "Done" : "Exit", job->cmd);
+        cli_sched_cancel(id);
+        finished++;
+    }
+
+    return finished;
+}
+
+uint8_t cli_sched_service(void)
+{
+    uint8_t executed = CLI_Sched_s.tasks ? _tasks_service() : 0;
+    uint32_t now = CLI_GETMS();
+    uint32_t lag = now - CLI_Sched_s.lastMs;
+
+    if ((CLI_Sched_s.count == 0) || ((lag == 0) && (CLI_Sched_s.eager == 0))) {
+        CLI_Sched_s.lastMs = now;
+        return executed;
+    }
+
+    // visit slots passed since last call, all slots at most once
+    if (lag > CLI_SCHED_WHEEL_SIZE)
+        lag = CLI_SCHED_WHEEL_SIZE;
+
+    uint32_t due = CLI_Sched_s.eager;
+    for (uint32_t t = now - lag + 1; t != now + 1; t++) {
+        for (int8_t id = CLI_Sched_s.wheel[t & WHEEL_MSK]; id != JOB_NONE; id = CLI_Sched_s.jobs[id].next) {
+            if ((int32_t) (now - CLI_Sched_s.jobs[id].deadline) >= 0)
+                due |= 1UL << id;
+        }
+    }
+
+    CLI_Sched_s.lastMs = now;
+
+    for (uint8_t id = 0; due != 0; id++, due >>= 1) {
+        CLI_Job_t* job = &CLI_Sched_s.jobs[id];
+
+        if (!(due & 1UL) || !job->active)
+            continue;
+
+        if ((job->remaining != 0) && (--job->remaining == 0)) {
+            cli_sched_cancel(id);
+        } else if (job->periodMs != 0) {
+            _wheel_remove(id);
+
+            // keep phase of period, skip missed periods
+            job->deadline += job->periodMs;
+            if ((int32_t) (now - job->deadline) >= 0)
+                job->deadline = now + job->periodMs;
+            _wheel_insert(id);
+        }
+
+        executed++;
+        CLI_Result_t result = cli_execute(job->cmd);
+        if ((result != CLI_OK) && (result != CLI_Continue)) {
+            CLI_PRINTF("\r\njob %d: \"%s\" failed, cancel", (int) id, job->cmd);
+            cli_sched_cancel(id);
+        }
+    }
+
+    return executed;
+}
+
+void cli_sched_print(void)
+{
+    uint32_t now = CLI_GETMS();
+
+    CLI_PRINTF("\r\n%-3s %8s %8s %8s  %s", "id", "period", "left", "next", "command");
+
+    for (uint8_t i = 0; i < CLI_SCHED_MAX_JOBS; i++) {
+        CLI_Job_t* job = &CLI_Sched_s.jobs[i];
+
+        if (!job->active)
+            continue;
+
+        if (job->isTask) {
+            CLI_PRINTF("\r\n%-3d %8s %8s %8s  %s &  (step %u)", (int) i, "-", "-", "-", job->cmd, (unsigned int) job->step);
+            continue;
+        }
+
+        int32_t next = (int32_t) (job->deadline - now);
+        CLI_PRINTF("\r\n%-3d %6ums ", (int) i, (unsigned int) job->periodMs);
+        if (job->remaining)
+            CLI_PRINTF("%8u ", (unsigned int) job->remaining)
+        else
+            CLI_PRINTF("%8s ", "-")
+        CLI_PRINTF("%6dms  %s", (int) (next > 0 ? next : 0), job->cmd);
+    }
+}
+
+uint32_t cli_sched_get_ram_size(void)
+{
+    return sizeof(CLI_Sched_s);
+}
+
+#endif // CLI_SCHED_EN == 1
@@ -0,0 +1,72 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_SCHED_H_
+#define _CLI_SCHED_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Init scheduler */
+void cli_sched_init(void);
+
+/**
+ * @brief Add job to scheduler
+ * @param cmd - command string include arguments
+ * @param periodMs - period between executions in ms, 0 - on every cli_sched_service
+ * @param count - count executions, 0 - until cancel
+ * @return id job or -1 if no free slot
+ * */
+int8_t cli_sched_add(const char* cmd, uint32_t periodMs, uint32_t count);
+
+/**
+ * @brief Add background job: resumable command, one step on every cli_loop_service
+ * @param cmd - command string include arguments
+ * @return id job or -1 if no free slot
+ * */
+int8_t cli_sched_add_task(const char* cmd);
+
+/** @brief Cancel job by id */
+bool cli_sched_cancel(uint8_t id);
+
+/**
+ * @brief Cancel all jobs
+ * @param tasks - true: cancel background jobs too, false: only periodic jobs
+ * */
+void cli_sched_cancel_all(bool tasks);
+
+/** @brief Count active jobs */
+uint8_t cli_sched_count(void);
+
+/**
+ * @brief Execute due jobs and one step of background jobs, call from cli_loop_service
+ * @return count executed periodic jobs and finished background jobs
+ * */
+uint8_t cli_sched_service(void);
+
+/** @brief Print list of active jobs */
+void cli_sched_print(void);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_sched_get_ram_size(void);
+
+#endif // _CLI_SCHED_H_
@@ -0,0 +1,389 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_script.h"
+#include "tinystring.h"
+#include "cli_arena.h"
+
+#if (CLI_SCRIPT_EN == 1)
+
+#if (CLI_SCRIPT_FILE_EN == 1)
+#include <stdio.h>
+#endif
+
+typedef enum{
+    CHAIN_SEQ = 0,                  // ';'  - always execute next
+    CHAIN_AND,                      // "&&" - execute next if previous OK
+    CHAIN_OR                        // "||" - execute next if previous failed
+}CLI_ChainOp_t;
+
+static struct{
+    const char* name;
+    const char* script;
+}CLI_Scripts_s[CLI_SCRIPT_MAX];
+
+bool cli_script_is_chain(const char* line)
+{
+    for (; *line != '\0'; line++) {
+        if ((*line == ';') ||
+            ((line[0] == '&') && (line[1] == '&')) ||
+            ((line[0] == '|') && (line[1] == '|')))
+            return true;
+    }
+
+    return false;
+}
+
+/** @brief Find next line to execute, skip empty and comment lines */
+static bool _next_line(CLI_ScriptCursor_t* cur)
+{
+    const char* script = cur->script;
+
+    while ((cur->next < cur->len) && (script[cur->next] != '\0')) {
+        uint32_t from = cur->next, to = from;
+
+        while ((to < cur->len) && (script[to] != '\0') && (script[to] != '\n'))
+            to++;
+
+        cur->lineNum++;
+        cur->next = ((to < cur->len) && (script[to] == '\n')) ? to + 1 : cur->len;
+
+        while ((from < to) && ((script[from] == ' ') || (script[from] == '\t')))
+            from++;
+        while ((to > from) && ((script[to - 1] == '\r') || (script[to - 1] == ' ')))
+            to--;
+
+        // chain typed as command line has no comments
+        if ((to > from) && (cur->chain || (script[from] != '#'))) {
+            cur->pos = from;
+            cur->lineEnd = to;
+            cur->op = CHAIN_SEQ;
+            cur->last = CLI_OK;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Copy next command of current line to cmd, skip commands of unmet "&&", "||"
+ * @return false at end of line
+ * */
+static bool _next_command(CLI_ScriptCursor_t* cur, uint32_t* len)
+{
+    const char* line = cur->script;
+
+    while (cur->pos <= cur->lineEnd) {
+        uint32_t i = cur->pos;
+        uint8_t nextOp = CHAIN_SEQ;
+        uint32_t opLen = 1;
+
+        for (; i < cur->lineEnd; i++) {
+            if (line[i] == ';')
+                break;
+            if ((i + 1 < cur->lineEnd) && (line[i] == '&') && (line[i + 1] == '&')) {
+                nextOp = CHAIN_AND;
+                opLen = 2;
+                break;
+            }
+            if ((i + 1 < cur->lineEnd) && (line[i] == '|') && (line[i + 1] == '|')) {
+                nextOp = CHAIN_OR;
+                opLen = 2;
+                break;
+            }
+        }
+
+        // trim command
+        uint32_t from = cur->pos, to = i;
+        while ((from < to) && (line[from] == ' '))
+            from++;
+        while ((to > from) && (line[to - 1] == ' '))
+            to--;
+
+        bool run = (cur->op == CHAIN_SEQ) ||
+                   ((cur->op == CHAIN_AND) && (cur->last == CLI_OK)) ||
+                   ((cur->op == CHAIN_OR) && (cur->last != CLI_OK));
+
+        cur->op = nextOp;
+        cur->pos = (i < cur->lineEnd) ? i + opLen : cur->lineEnd + 1;
+
+        if (run && (to > from)) {
+            *len = to - from;
+            if (*len <= CLI_CMD_BUF_SIZE) {
+                cli_memcpy(cur->cmd, line + from, *len);
+                cur->cmd[*len] = '\0';
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** @brief Release script, return result of script */
+static CLI_Result_t _finish(CLI_ScriptCursor_t* cur)
+{
+    cli_script_abort(cur);
+    return cur->st.result;
+}
+
+void cli_script_begin(CLI_ScriptCursor_t* cur, const char* script, uint32_t len, bool chain)
+{
+    cur->script = script;
+    cur->len = len;
+    cur->next = 0;
+    cur->lineNum = 0;
+    cur->running = false;
+    cur->heap = false;
+    cur->chain = chain;
+    cur->st = (CLI_ScriptStatus_t) {0, 0, 0, CLI_OK};
+    cur->inLine = _next_line(cur);
+}
+
+CLI_Result_t cli_script_step(CLI_ScriptCursor_t* cur)
+{
+    uint32_t len;
+
+    if (cur->running) {
+        CLI_Result_t result = cli_execute_step(cur->cmd, cur->state, cur->step);
+
+        if (result == CLI_Continue) {
+            if (cur->step < UINT16_MAX)
+                cur->step++;
+            return CLI_Continue;
+        }
+        cur->running = false;
+        cur->last = result;
+    } else if (!cur->inLine) {
+        return _finish(cur);
+    }
+
+    // rest of line, resumable command continues on next call
+    while (_next_command(cur, &len)) {
+        cur->st.commands++;
+
+        if (len > CLI_CMD_BUF_SIZE) {
+            cur->last = CLI_ArgErr;
+            continue;
+        }
+
+        cli_memset(cur->state, 0, CLI_JOB_STATE_SIZE);
+        CLI_Result_t result = cli_execute_step(cur->cmd, cur->state, 0);
+
+        if (result == CLI_Continue) {
+            cur->step = 1;
+            cur->running = true;
+            return CLI_Continue;
+        }
+        cur->last = result;
+    }
+
+    // line done, stop on first error, next line on next call
+    cur->st.lines++;
+    cur->st.result = cur->last;
+    if ((cur->last != CLI_OK) || cli_get_int_state()) {
+        if (cur->last == CLI_OK)
+            cur->st.result = CLI_WorkInt;
+        cur->st.errLine = cur->lineNum;
+        return _finish(cur);
+    }
+
+    cur->inLine = _next_line(cur);
+
+    return cur->inLine ? CLI_Continue : _finish(cur);
+}
+
+void cli_script_abort(CLI_ScriptCursor_t* cur)
+{
+#if (CLI_SCRIPT_FILE_EN == 1)
+    if (cur->heap)
+        cli_free((void*) cur->script);
+#endif
+    cur->heap = false;
+    cur->running = false;
+    cur->inLine = false;
+}
+
+/** @brief Execute script up to end, resumable command gets at most CLI_SCRIPT_SPIN_MAX steps */
+static CLI_Result_t _run_blocking(CLI_ScriptCursor_t* cur)
+{
+    CLI_Result_t result;
+
+    while ((result = cli_script_step(cur)) == CLI_Continue) {
+        if (!cur->running)
+            continue;
+
+        if (cli_get_int_state()) {
+            cur->st.result = CLI_WorkInt;
+        } else if (cur->step > CLI_SCRIPT_SPIN_MAX) {
+            CLI_PRINTF("\r\n%s: not finished in %u steps", cur->cmd, (unsigned int) CLI_SCRIPT_SPIN_MAX);
+            cur->st.result = CLI_ExecErr;
+        } else {
+            continue;
+        }
+
+        cur->st.errLine = cur->lineNum;
+        return _finish(cur);
+    }
+
+    return result;
+}
+
+CLI_Result_t cli_script_execute_chain(const char* line, uint32_t len, uint16_t* commands)
+{
+    CLI_ScriptCursor_t cur;
+
+    cli_script_begin(&cur, line, len, true);
+    CLI_Result_t result = _run_blocking(&cur);
+    if (commands != NULL)
+        *commands += cur.st.commands;
+
+    return result;
+}
+
+CLI_Result_t cli_script_run(const char* script, uint32_t len, CLI_ScriptStatus_t* status)
+{
+    CLI_ScriptCursor_t cur;
+
+    cli_script_begin(&cur, script, len, false);
+    CLI_Result_t result = _run_blocking(&cur);
+    if (status != NULL)
+        *status = cur.st;
+
+    return result;
+}
+
+bool cli_script_add(const char* name, const char* script)
+{
+    for (uint8_t i = 0; i < CLI_SCRIPT_MAX; i++) {
+        if ((CLI_Scripts_s[i].name == NULL) || _strcmp(CLI_Scripts_s[i].name, name)) {
+            CLI_Scripts_s[i].name = name;
+            CLI_Scripts_s[i].script = script;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char* cli_script_find(const char* name)
+{
+    for (uint8_t i = 0; i < CLI_SCRIPT_MAX; i++) {
+        if ((CLI_Scripts_s[i].name != NULL) && _strcmp(CLI_Scripts_s[i].name, name))
+            return CLI_Scripts_s[i].script;
+    }
+
+    return NULL;
+}
+
+#if (CLI_SCRIPT_FILE_EN == 1)
+/**
+ * @brief Read script file
+ * @param arena - scratch arena first, heap for big files
+ * @param heap - text is allocated by cli_malloc
+ * @return CLI_NotFound - no file or not regular file, CLI_ExecErr - no memory or read error
+ * */
+static CLI_Result_t _read_file(const char* path, bool arena, char** text, uint32_t* len, bool* heap)
+{
+    FILE* f = fopen(path, "rb");
+
+    *text = NULL;
+    *len = 0;
+    *heap = false;
+
+    if (f == NULL)
+        return CLI_NotFound;
+
+    // size of directory or stream is not size of script
+    long size = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+    if ((size < 0) || ((unsigned long) size > UINT32_MAX) || (fseek(f, 0, SEEK_SET) != 0)) {
+        fclose(f);
+        return CLI_NotFound;
+    }
+
+    if (size == 0) {
+        fclose(f);
+        return CLI_OK;
+    }
+
+    char* script = arena ? cli_arena_alloc((size_t) size) : NULL;
+    if (script == NULL) {
+        script = cli_malloc((size_t) size);
+        *heap = (script != NULL);
+    }
+    if (script == NULL) {
+        fclose(f);
+        return CLI_ExecErr;
+    }
+
+    *text = script;
+    *len = (uint32_t) fread(script, 1, (size_t) size, f);
+    bool failed = (ferror(f) != 0);
+    fclose(f);
+
+    return failed ? CLI_ExecErr : CLI_OK;
+}
+
+CLI_Result_t cli_script_run_file(const char* path, CLI_ScriptStatus_t* status)
+{
+    uint32_t mark = cli_arena_mark();
+    char* script;
+    uint32_t len;
+    bool heap;
+
+    CLI_Result_t result = _read_file(path, true, &script, &len, &heap);
+    if (result == CLI_OK)
+        result = cli_script_run((script != NULL) ? script : "", len, status);
+
+    if (heap)
+        cli_free(script);
+    cli_arena_release(mark);
+
+    return result;
+}
+
+CLI_Result_t cli_script_begin_file(CLI_ScriptCursor_t* cur, const char* path)
+{
+    char* script;
+    uint32_t len;
+    bool heap;
+
+    CLI_Result_t result = _read_file(path, false, &script, &len, &heap);
+    if (result != CLI_OK) {
+        if (heap)
+            cli_free(script);
+        return result;
+    }
+
+    cli_script_begin(cur, (script != NULL) ? script : "", len, false);
+    cur->heap = heap;
+
+    return CLI_OK;
+}
+#endif
+
+uint32_t cli_script_get_ram_size(void)
+{
+    return sizeof(CLI_Scripts_s);
+}
+
+#endif // CLI_SCRIPT_EN == 1
@@ -0,0 +1,121 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_SCRIPT_H_
+#define _CLI_SCRIPT_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Summary of script execution */
+typedef struct{
+    uint16_t lines;                 // count executed lines
+    uint16_t commands;              // count executed commands
+    uint16_t errLine;               // number of line with error (from 1), 0 - no error
+    CLI_Result_t result;            // result of last executed line
+}CLI_ScriptStatus_t;
+
+/** @brief Chain or script executed across cli_loop_service calls, one line or one step per call */
+typedef struct{
+    const char* script;             // script text or chain line, must be valid while executed
+    uint32_t len;                   // length of script
+    uint32_t next;                  // offset of next line
+    uint32_t pos;                   // offset of next command in current line
+    uint32_t lineEnd;               // end of current line
+    uint16_t lineNum;               // number of current line (from 1)
+    uint16_t step;                  // next step of resumable command
+    uint8_t op;                     // chain operator before next command
+    bool inLine;                    // current line is not executed
+    bool running;                   // command in cmd returned CLI_Continue
+    bool chain;                     // chain of command line, '#' is not comment
+    bool heap;                      // script allocated by cli_malloc, freed at end
+    CLI_Result_t last;              // result of last executed command of line
+    CLI_ScriptStatus_t st;          // summary of execution
+    char cmd[CLI_CMD_BUF_SIZE + 1]; // current command
+    uint8_t state[CLI_JOB_STATE_SIZE] __attribute__((aligned(8)));  // state of current command
+}CLI_ScriptCursor_t;
+
+/** @brief Check command string contains chain operators ';', "&&", "||" */
+bool cli_script_is_chain(const char* line);
+
+/**
+ * @brief Execute chain of commands up to end: "cmd1; cmd2 && cmd3 || cmd4"
+ * @param line - command string
+ * @param len - length of line
+ * @param commands - counter of executed commands or NULL
+ * @return result of last executed command
+ * */
+CLI_Result_t cli_script_execute_chain(const char* line, uint32_t len, uint16_t* commands);
+
+/**
+ * @brief Start chain or script for cli_script_step
+ * @param cur - cursor
+ * @param script - script text or chain line
+ * @param len - length of script
+ * @param chain - chain of command line
+ * */
+void cli_script_begin(CLI_ScriptCursor_t* cur, const char* script, uint32_t len, bool chain);
+
+/**
+ * @brief Execute one line or one step of resumable command, call on every cli_loop_service
+ * @return CLI_Continue - not finished, else result of script (cur->st - summary)
+ * */
+CLI_Result_t cli_script_step(CLI_ScriptCursor_t* cur);
+
+/** @brief Stop script and free its text, called on finish or abort */
+void cli_script_abort(CLI_ScriptCursor_t* cur);
+
+/**
+ * @brief Execute multi-line script up to end without prompts, stop on first error
+ * @param script - script text, lines separated by '\n', '#' - comment
+ * @param len - length of script
+ * @param status - summary of execution or NULL
+ * @return result of last executed line
+ * */
+CLI_Result_t cli_script_run(const char* script, uint32_t len, CLI_ScriptStatus_t* status);
+
+/**
+ * @brief Register named script for "run" command
+ * @param name - script name
+ * @param script - script text, '\0' terminated, must be valid while registered
+ * @return false if registry is full
+ * */
+bool cli_script_add(const char* name, const char* script);
+
+/** @brief Find registered script by name, NULL if not found */
+const char* cli_script_find(const char* name);
+
+#if (CLI_SCRIPT_FILE_EN == 1)
+/** @brief Execute script from file (host port) */
+CLI_Result_t cli_script_run_file(const char* path, CLI_ScriptStatus_t* status);
+
+/**
+ * @brief Read script file to heap and start it for cli_script_step (host port)
+ * @return CLI_OK, CLI_NotFound - no file, CLI_ExecErr - no memory or read error
+ * */
+CLI_Result_t cli_script_begin_file(CLI_ScriptCursor_t* cur, const char* path);
+#endif
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_script_get_ram_size(void);
+
+#endif // _CLI_SCRIPT_H_
@@ -0,0 +1,156 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#include "cli_stats.h"
+
+#if (CLI_CMD_STATS_EN == 1)
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define STATS_CLOCK_DWT
+#define DWT_CTRL            (*(volatile uint32_t*) 0xE0001000)   // DWT control register
+#define DWT_CYCCNT          (*(volatile uint32_t*) 0xE0001004)   // DWT cycle counter
+#define DEMCR               (*(volatile uint32_t*) 0xE000EDFC)   // Debug exception and monitor control
+#define DEMCR_TRCENA_Msk    (1UL << 24)
+#define DWT_CYCCNTENA_Msk   (1UL << 0)
+#elif defined(__unix__) || defined(__APPLE__)
+#define STATS_CLOCK_HOST
+#include <time.h>
+#endif
+
+void cli_stats_init(void)
+{
+#if defined(STATS_CLOCK_DWT)
+    DEMCR |= DEMCR_TRCENA_Msk;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CYCCNTENA_Msk;
+#endif
+}
+
+inline uint32_t cli_stats_get_cycles(void)
+{
+#if defined(STATS_CLOCK_DWT)
+    return DWT_CYCCNT;
+#elif defined(STATS_CLOCK_HOST)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ts.tv_sec * 1000000000u + (uint32_t) ts.tv_nsec;
+#else
+    return (uint32_t) CLI_GET_US();
+#endif
+}
+
+const char* cli_stats_get_unit(void)
+{
+#if defined(STATS_CLOCK_DWT)
+    return "cyc";
+#elif defined(STATS_CLOCK_HOST)
+    return "ns";
+#else
+    return "us";
+#endif
+}
+
+void cli_stats_reset(CLI_CmdStats_t* stats)
+{
+    stats->calls = 0;
+    stats->errors = 0;
+    stats->overruns = 0;
+    stats->min = UINT32_MAX;
+    stats->max = 0;
+    stats->total = 0;
+
+    for (uint8_t i = 0; i < CLI_STATS_HIST_SIZE; i++)
+        stats->hist[i] = 0;
+}
+
+/// \brief Histogram bucket: 0 - less than 2^CLI_STATS_HIST_SHIFT, next buckets double range
+static inline uint8_t _hist_index(uint32_t cycles)
+{
+    cycles >>= CLI_STATS_HIST_SHIFT;
+    if (cycles == 0)
+        return 0;
+
+    uint8_t index = (uint8_t) (32 - __builtin_clz(cycles));
+    return (index < CLI_STATS_HIST_SIZE) ? index : CLI_STATS_HIST_SIZE - 1;
+}
+
+void cli_stats_update(CLI_CmdStats_t* stats, uint32_t cycles, CLI_Result_t result, bool overrun)
+{
+    stats->calls++;
+    if ((result != CLI_OK) && (result != CLI_Continue))
+        stats->errors++;
+    if (overrun)
+        stats->overruns++;
+
+    if (cycles < stats->min)
+        stats->min = cycles;
+    if (cycles > stats->max)
+        stats->max = cycles;
+    stats->total += cycles;
+
+    uint16_t* bucket = &stats->hist[_hist_index(cycles)];
+    if (*bucket < UINT16_MAX)
+        (*bucket)++;
+}
+
+void cli_stats_print_header(bool machine)
+{
+    if (machine) {
+        CLI_PRINTF("\r\n#name,calls,errors,overruns,min,mean,max,hist[%d] unit=%s shift=%d",
+                   CLI_STATS_HIST_SIZE, cli_stats_get_unit(), CLI_STATS_HIST_SHIFT);
+    } else {
+        CLI_PRINTF("\r\n%-10s %8s %6s %4s %10s %10s %10s  (%s)", "name", "calls", "errors", "ovr", "min", "mean", "max",
+                   cli_stats_get_unit());
+    }
+}
+
+void cli_stats_print(const char* name, const CLI_CmdStats_t* stats, bool machine, bool hist)
+{
+    uint32_t min = stats->calls ? stats->min : 0;
+    uint32_t mean = stats->calls ? (uint32_t) (stats->total / stats->calls) : 0;
+
+    if (machine) {
+        CLI_PRINTF("\r\n%s,%u,%u,%u,%u,%u,%u", name, (unsigned int) stats->calls, (unsigned int) stats->errors,
+                   (unsigned int) stats->overruns, (unsigned int) min, (unsigned int) mean, (unsigned int) stats->max);
+        for (uint8_t i = 0; i < CLI_STATS_HIST_SIZE; i++)
+            CLI_PRINTF(",%u", (unsigned int) stats->hist[i]);
+        return;
+    }
+
+    CLI_PRINTF("\r\n%-10s %8u %6u %4u %10u %10u %10u", name, (unsigned int) stats->calls, (unsigned int) stats->errors,
+               (unsigned int) stats->overruns, (unsigned int) min, (unsigned int) mean, (unsigned int) stats->max);
+
+    if (hist && stats->calls) {
+        for (uint8_t i = 0; i < CLI_STATS_HIST_SIZE; i++) {
+            if (stats->hist[i] == 0)
+                continue;
+            // bucket i: [2^(i + shift - 1), 2^(i + shift)), bucket 0: [0, 2^shift)
+            uint32_t to = 1UL << (i + CLI_STATS_HIST_SHIFT);
+            uint32_t from = i ? (to >> 1) : 0;
+            if (i == CLI_STATS_HIST_SIZE - 1)
+                CLI_PRINTF("\r\n    %10u..%-10s %u", (unsigned int) from, "", (unsigned int) stats->hist[i])
+            else
+                CLI_PRINTF("\r\n    %10u..%-10u %u", (unsigned int) from, (unsigned int) to, (unsigned int) stats->hist[i])
+        }
+    }
+}
+
+#endif // CLI_CMD_STATS_EN == 1
@@ -0,0 +1,73 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_STATS_H_
+#define _CLI_STATS_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Execute statistics of one command */
+typedef struct{
+    uint32_t calls;                             // count calls
+    uint32_t errors;                            // count calls with result != CLI_OK
+    uint32_t overruns;                          // count calls exceeded deadline
+    uint32_t min;                               // min execute time in cycles
+    uint32_t max;                               // max execute time in cycles
+    uint64_t total;                             // sum execute time in cycles
+    uint16_t hist[CLI_STATS_HIST_SIZE];         // log2 histogram execute time
+}CLI_CmdStats_t;
+
+/** @brief Init cycle counter */
+void cli_stats_init(void);
+
+/** @brief Get high-resolution counter: DWT cycles on target, ns on host, us otherwise */
+uint32_t cli_stats_get_cycles(void);
+
+/** @brief Name unit of cli_stats_get_cycles */
+const char* cli_stats_get_unit(void);
+
+/** @brief Reset statistics */
+void cli_stats_reset(CLI_CmdStats_t* stats);
+
+/**
+ * @brief Append one execute to statistics
+ * @param stats - command statistics
+ * @param cycles - execute time
+ * @param result - execute result
+ * @param overrun - execute exceeded deadline of command
+ * */
+void cli_stats_update(CLI_CmdStats_t* stats, uint32_t cycles, CLI_Result_t result, bool overrun);
+
+/**
+ * @brief Print statistics of one command
+ * @param name - command name
+ * @param stats - command statistics
+ * @param machine - true: one comma separated line, false: table row
+ * @param hist - print histogram (for table row)
+ * */
+void cli_stats_print(const char* name, const CLI_CmdStats_t* stats, bool machine, bool hist);
+
+/** @brief Print header for cli_stats_print */
+void cli_stats_print_header(bool machine);
+
+#endif // _CLI_STATS_H_
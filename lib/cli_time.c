@@ -32,18 +32,116 @@
 
 #include "cli_time.h"
 
+#if (CLI_TIMELEFT_EN == 1)
+#if ((1000000 % CLI_TICK_FREQ_HZ) != 0)
+#error "CLI_TICK_FREQ_HZ must divide 1000000"
+#endif
+#define US_PER_TICK         (1000000 / CLI_TICK_FREQ_HZ)
+#endif
+
+volatile uint64_t _tick;                // SysTick_CLI counter
+#if (CLI_TIMELEFT_EN == 1) && (CLI_TICK_FREQ_HZ != 1000)
+static volatile uint32_t _tick_ms;      // system time in ms, updated by SysTick_CLI
+static uint32_t _tick_ms_frac;          // ms remainder in 1/CLI_TICK_FREQ_HZ parts
+#endif
+
 static uint32_t def_time_ms;
 
+/// \brief Two-digit decimal lookup table "00".."99"
+static const char _digits2[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/// \brief Divide by 1000, reciprocal multiply exact for all uint32_t values
+static inline uint32_t _div1000(uint32_t value)
+{
+    return (uint32_t) (((uint64_t) value * 0x10624DD3u) >> 38);
+}
+
+/// \brief Divide by 60, reciprocal multiply exact for all uint32_t values
+static inline uint32_t _div60(uint32_t value)
+{
+    return (uint32_t) (((uint64_t) value * 0x88888889u) >> 37);
+}
+
+void SysTick_CLI(void)
+{
+    _tick++;
+#if (CLI_TIMELEFT_EN == 1) && (CLI_TICK_FREQ_HZ != 1000)
+    uint32_t ms = _tick_ms + 1000 / CLI_TICK_FREQ_HZ;
+    _tick_ms_frac += 1000 % CLI_TICK_FREQ_HZ;
+    if (_tick_ms_frac >= CLI_TICK_FREQ_HZ) {
+        _tick_ms_frac -= CLI_TICK_FREQ_HZ;
+        ms++;
+    }
+    _tick_ms = ms;
+#endif
+#if (CLI_WATCHDOG_EN == 1)
+    cli_watchdog_tick();
+#endif
+}
+
+/// \brief Read 64-bit tick without tearing on 32-bit cores:
+/// re-read high word until it is stable around low word read
+uint64_t cli_time_get_tick(void)
+{
+#if (UINTPTR_MAX > 0xFFFFFFFFu)
+    return _tick;
+#else
+    const volatile uint32_t* word = (const volatile uint32_t*) &_tick;
+    uint32_t hi, lo;
+    do {
+        hi = word[1];
+        lo = word[0];
+    } while (hi != word[1]);
+
+    return ((uint64_t) hi << 32) | lo;
+#endif
+}
+
+uint64_t cli_time_get_us(void)
+{
+#if (CLI_TIMELEFT_EN == 1)
+    return cli_time_get_tick() * US_PER_TICK;
+#else
+    return 0;
+#endif
+}
+
+uint32_t cli_time_get_ms(void)
+{
+#if (CLI_TIMELEFT_EN == 1) && (CLI_TICK_FREQ_HZ == 1000)
+    return (uint32_t) _tick;    // low word read is atomic
+#elif (CLI_TIMELEFT_EN == 1)
+    return _tick_ms;
+#else
+    return 0;
+#endif
+}
+
+void cli_time_reset(void)
+{
+    _tick = 0;
+#if (CLI_TIMELEFT_EN == 1) && (CLI_TICK_FREQ_HZ != 1000)
+    _tick_ms = 0;
+    _tick_ms_frac = 0;
+#endif
+}
+
 /// \brief Generate CLI_Time_t struct from milliseconds
 CLI_Time_t cli_time_get_time_ms(uint32_t msec)
 {
     CLI_Time_t res;
-    res.msec = msec % 1000;
-    uint32_t s = msec / 1000;
-    res.second = s % 60;
-    uint32_t m = s / 60;
-    res.minute = m % 60;
-    uint32_t h = s / 3600;
+    uint32_t s = _div1000(msec);
+    uint32_t m = _div60(s);
+    uint32_t h = _div60(m);
+
+    res.msec = msec - s * 1000;
+    res.second = s - m * 60;
+    res.minute = m - h * 60;
     res.hour = h;
 
     return res;
@@ -54,14 +152,115 @@ inline CLI_Time_t cli_time_get_plus_time_ms(uint32_t msec)
     return cli_time_get_time_ms(msec + def_time_ms);
 }
 
+/// \brief Write value 0..99 as two decimal digits
+static inline void _put2(char* dst, uint8_t value)
+{
+    dst[0] = _digits2[value * 2];
+    dst[1] = _digits2[value * 2 + 1];
+}
+
+/// \brief Full render ctx->tv to ctx->str, format "%02dh:%02dm:%02ds.%03d"
+static void _time_str_render(CLI_TimeStr_t* ctx)
+{
+    char tmp[10];
+    uint8_t n = 0;
+    uint32_t h = ctx->tv.hour;
+
+    do {
+        tmp[n++] = (char)('0' + h % 10);
+        h /= 10;
+    } while (h);
+
+    if (n < 2)
+        tmp[n++] = '0';
+
+    ctx->hourLen = n;
+
+    char* p = ctx->str;
+    while (n)
+        *p++ = tmp[--n];
+
+    *p++ = 'h'; *p++ = ':';
+    _put2(p, ctx->tv.minute); p += 2;
+    *p++ = 'm'; *p++ = ':';
+    _put2(p, ctx->tv.second); p += 2;
+    *p++ = 's'; *p++ = '.';
+    *p++ = (char)('0' + ctx->tv.msec / 100);
+    _put2(p, ctx->tv.msec % 100); p += 2;
+    *p = '\0';
+
+    ctx->isValid = true;
+}
+
+void cli_time_str_init(CLI_TimeStr_t* ctx)
+{
+    ctx->lastMs = 0;
+    ctx->hourLen = 0;
+    ctx->isValid = false;
+    ctx->str[0] = '\0';
+}
+
+const char* cli_time_str_update(CLI_TimeStr_t* ctx, uint32_t msec)
+{
+    msec += def_time_ms;
+    uint32_t lastMs = ctx->lastMs;
+    uint32_t delta = msec - lastMs;
+
+    if (ctx->isValid && (delta == 0))
+        return ctx->str;
+
+    ctx->lastMs = msec;
+
+    // first call, big step, time went back or counter wrapped - full render
+    if (!ctx->isValid || (msec < lastMs) || (delta >= 1000)) {
+        ctx->tv = cli_time_get_time_ms(msec);
+        _time_str_render(ctx);
+        return ctx->str;
+    }
+
+    // small step forward: carry through fields, rewrite only changed ones
+    // offsets from end of hours: "h:MMm:SSs.mmm"
+    char* p = ctx->str + ctx->hourLen;
+    uint16_t ms = ctx->tv.msec + (uint16_t) delta;
+
+    if (ms >= 1000) {
+        ms -= 1000;
+        if (++ctx->tv.second >= 60) {
+            ctx->tv.second = 0;
+            if (++ctx->tv.minute >= 60) {
+                ctx->tv.minute = 0;
+                ctx->tv.hour++;
+                ctx->tv.msec = ms;
+                _time_str_render(ctx);  // count hour digits may change
+                return ctx->str;
+            }
+            _put2(p + 2, ctx->tv.minute);
+        }
+        _put2(p + 6, ctx->tv.second);
+    }
+
+    ctx->tv.msec = ms;
+    p[10] = (char)('0' + ms / 100);
+    _put2(p + 11, ms % 100);
+
+    return ctx->str;
+}
+
 char* cli_time_get_curr_time_str(void)
 {
-    static char tv_str[20];
-    CLI_Time_t tv = {0};
+    static CLI_TimeStr_t ctx;   // default context, for reentrant use own CLI_TimeStr_t
+    uint32_t ms = 0;
 #if (CLI_TIMELEFT_EN == 1)
-    uint32_t ms = CLI_GETMS();
-    tv = cli_time_get_plus_time_ms(ms);
+    ms = CLI_GETMS();
+#endif
+    return (char*) cli_time_str_update(&ctx, ms);
+}
+
+uint32_t cli_time_get_ram_size(void)
+{
+    uint32_t size = sizeof(_tick) + sizeof(def_time_ms) + sizeof(CLI_TimeStr_t);
+#if (CLI_TIMELEFT_EN == 1) && (CLI_TICK_FREQ_HZ != 1000)
+    size += sizeof(_tick_ms) + sizeof(_tick_ms_frac);
 #endif
-    sprintf(tv_str, "%02dh:%02dm:%02ds.%03d", (int) tv.hour, (int) tv.minute, (int) tv.second, (int) tv.msec);
-    return tv_str;
+    return size;
 }
@@ -35,7 +35,7 @@
 
 #include "cli_config.h"
 
-#define CLI_GETMS()         ((float) CLI_GET_US() / 1000)    // System time in ms
+#define CLI_GETMS()         (cli_time_get_ms())             // System time in ms
 
 typedef struct{
     uint32_t hour;
@@ -44,6 +44,29 @@ typedef struct{
     uint16_t msec;
 }CLI_Time_t;
 
+#define CLI_TIME_STR_SIZE   (20)                            // "HHh:MMm:SSs.mmm" + wide hours + '\0'
+
+/** @brief Cached timestamp string, one per output context */
+typedef struct{
+    CLI_Time_t tv;                  // last rendered time
+    uint32_t lastMs;                // last rendered time in ms
+    uint8_t hourLen;                // count hour digits in str
+    bool isValid;                   // str contains rendered time
+    char str[CLI_TIME_STR_SIZE];    // rendered time "%02dh:%02dm:%02ds.%03d"
+}CLI_TimeStr_t;
+
+
+/** @brief Get SysTick_CLI counter, consistent 64-bit read without lock */
+uint64_t cli_time_get_tick(void);
+
+/** @brief Get system time in us */
+uint64_t cli_time_get_us(void);
+
+/** @brief Get system time in ms (wraps after ~49 days) */
+uint32_t cli_time_get_ms(void);
+
+/** @brief Reset system time counters */
+void cli_time_reset(void);
 
 /** @brief Get time in millisecond  */
 CLI_Time_t cli_time_get_time_ms(uint32_t msec);
@@ -53,4 +76,17 @@ CLI_Time_t cli_time_get_plus_time_ms(uint32_t msec);
 
 char* cli_time_get_curr_time_str(void);
 
+/** @brief Init cached timestamp context */
+void cli_time_str_init(CLI_TimeStr_t* ctx);
+
+/** @brief Update cached timestamp to msec (+ correction), rewrite only changed fields
+ * @param ctx - cached timestamp context
+ * @param msec - time in ms
+ * @return pointer on rendered string inside ctx
+ * */
+const char* cli_time_str_update(CLI_TimeStr_t* ctx, uint32_t msec);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_time_get_ram_size(void);
+
 #endif // _CLI_TIME_H_
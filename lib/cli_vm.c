@@ -0,0 +1,908 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#include "cli_vm.h"
+#include "tinystring.h"
+
+#if (CLI_VM_EN == 1)
+
+#if (CLI_VM_MAX_VARS < 2) || (CLI_VM_MAX_VARS > 255)
+#error "CLI_VM_MAX_VARS must be 2..255"
+#endif
+#if (CLI_VM_CODE_SIZE > 65535)
+#error "CLI_VM_CODE_SIZE must be <= 65535"
+#endif
+
+#define VAR_RC              (0)         // result of last "call"
+#define VAR_RET             (1)         // value of cli_vm_set_ret() in last "call"
+#define CALL_VAR            (0x01)      // in "call" template: next byte is variable index
+
+/** @brief Bytecode instructions */
+typedef enum{
+    OP_HALT = 0,
+    OP_PUSH8,           // int8 operand
+    OP_PUSH32,          // int32 operand, little endian
+    OP_LOAD,            // variable index
+    OP_STORE,           // variable index
+    OP_JMP,             // uint16 address
+    OP_JZ,              // uint16 address, pop
+    OP_CALL,            // uint8 length, template
+    OP_PRINT,
+    OP_SLEEP,
+    OP_NEG,
+    OP_NOT,
+    OP_INV,
+    OP_MUL,             // binary operations, order as _binOps
+    OP_DIV,
+    OP_MOD,
+    OP_ADD,
+    OP_SUB,
+    OP_SHL,
+    OP_SHR,
+    OP_LT,
+    OP_LE,
+    OP_GT,
+    OP_GE,
+    OP_EQ,
+    OP_NE,
+    OP_AND,
+    OP_XOR,
+    OP_OR,
+    OP_LAND,
+    OP_LOR,
+}CLI_VmOp_t;
+
+/** @brief Binary operators, two-character before one-character */
+static const struct{
+    char str[3];
+    uint8_t prec;
+    uint8_t op;
+}_binOps[] = {
+    {"||", 1, OP_LOR}, {"&&", 2, OP_LAND}, {"==", 6, OP_EQ}, {"!=", 6, OP_NE},
+    {"<=", 7, OP_LE},  {">=", 7, OP_GE},   {"<<", 8, OP_SHL}, {">>", 8, OP_SHR},
+    {"|", 3, OP_OR},   {"^", 4, OP_XOR},   {"&", 5, OP_AND},  {"<", 7, OP_LT},
+    {">", 7, OP_GT},   {"+", 9, OP_ADD},   {"-", 9, OP_SUB},  {"*", 10, OP_MUL},
+    {"/", 10, OP_DIV}, {"%", 10, OP_MOD},
+};
+
+/** @brief Kind of open block in compiler */
+typedef enum{
+    BLOCK_IF = 0,
+    BLOCK_ELSE,
+    BLOCK_WHILE,
+    BLOCK_FOR,
+}CLI_VmBlock_t;
+
+/** @brief Compiled program */
+typedef struct{
+    const char* name;
+    uint16_t offset;                    // start in code pool
+    uint16_t len;                       // size of bytecode
+}CLI_VmProg_t;
+
+/** @brief Running program */
+typedef struct{
+    const CLI_VmProg_t* prog;
+    int32_t vars[CLI_VM_MAX_VARS];
+    int32_t stack[CLI_VM_STACK_SIZE];
+    uint8_t state[CLI_JOB_STATE_SIZE] __attribute__((aligned(8)));  // state of resumable command in "call"
+    uint32_t wakeMs;                    // end of "sleep"
+    uint16_t pc;
+    uint16_t step;                      // step of resumable command in "call"
+    uint8_t sp;
+    bool sleeping;
+    bool active;
+}CLI_VmRun_t;
+
+/** @brief Compiler state */
+typedef struct{
+    const char* p;                      // current position in line
+    const char* err;                    // error message, NULL - no error
+    uint8_t* code;                      // start of program in code pool
+    uint16_t pc;                        // size of emitted code
+    uint16_t size;                      // free space in code pool
+    uint8_t sp;                         // depth of stack at current position
+    uint8_t varCount;
+    uint8_t depth;                      // count open blocks
+    char names[CLI_VM_MAX_VARS][CLI_VM_NAME_SIZE + 1];
+    struct{
+        uint8_t type;
+        uint8_t var;                    // variable of "for"
+        uint16_t loop;                  // start of condition
+        uint16_t patch;                 // address of jump operand to end of block
+    }blocks[CLI_VM_MAX_DEPTH];
+}CLI_VmComp_t;
+
+static struct{
+    uint8_t code[CLI_VM_CODE_SIZE];
+    uint16_t used;
+    CLI_VmProg_t progs[CLI_VM_MAX_PROGS];
+    uint8_t countProgs;
+    CLI_VmRun_t runs[CLI_VM_MAX_RUN];
+    CLI_VmRun_t* current;               // program executing "call"
+}CLI_Vm_s;
+
+// ******************************* compiler *******************************
+
+static inline bool _is_alpha(char c)
+{
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || (c == '_');
+}
+
+static inline bool _is_digit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+static void _skip_spaces(CLI_VmComp_t* c)
+{
+    while ((*c->p == ' ') || (*c->p == '\t'))
+        c->p++;
+}
+
+static bool _is_eol(CLI_VmComp_t* c)
+{
+    _skip_spaces(c);
+    return (*c->p == '\0') || (*c->p == '\n') || (*c->p == '\r') || (*c->p == '#');
+}
+
+static void _error(CLI_VmComp_t* c, const char* msg)
+{
+    if (c->err == NULL)
+        c->err = msg;
+}
+
+/** @brief Read identifier to buf, return length or 0 */
+static uint8_t _ident(CLI_VmComp_t* c, char* buf)
+{
+    uint8_t len = 0;
+
+    _skip_spaces(c);
+    if (!_is_alpha(*c->p))
+        return 0;
+
+    while (_is_alpha(*c->p) || _is_digit(*c->p)) {
+        if (len >= CLI_VM_NAME_SIZE) {
+            _error(c, "name too long");
+            return 0;
+        }
+        buf[len++] = *c->p++;
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+
+/** @brief Compare token with text, stop on first mismatch */
+static bool _match(const char* p, const char* tok, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++) {
+        if (p[i] != tok[i])
+            return false;
+    }
+
+    return true;
+}
+
+/** @brief Skip token if matched */
+static bool _accept(CLI_VmComp_t* c, const char* tok)
+{
+    uint8_t len = (uint8_t) _strlen(tok);
+
+    _skip_spaces(c);
+    if (!_match(c->p, tok, len))
+        return false;
+
+    c->p += len;
+    return true;
+}
+
+static void _expect(CLI_VmComp_t* c, const char* tok)
+{
+    if (!_accept(c, tok))
+        _error(c, "syntax error");
+}
+
+static int16_t _find_var(CLI_VmComp_t* c, const char* name)
+{
+    for (uint8_t i = 0; i < c->varCount; i++) {
+        if (_strcmp(c->names[i], name))
+            return i;
+    }
+
+    return -1;
+}
+
+/** @brief Read variable name, create if not exist and create is true */
+static uint8_t _var(CLI_VmComp_t* c, bool create)
+{
+    char name[CLI_VM_NAME_SIZE + 1];
+
+    if (_ident(c, name) == 0) {
+        _error(c, "expected variable");
+        return 0;
+    }
+
+    int16_t id = _find_var(c, name);
+    if (id >= 0)
+        return (uint8_t) id;
+
+    if (!create) {
+        _error(c, "unknown variable");
+        return 0;
+    }
+
+    if (c->varCount >= CLI_VM_MAX_VARS) {
+        _error(c, "too many variables");
+        return 0;
+    }
+
+    _strcpy(name, 0, c->names[c->varCount], 0, _strlen(name) + 1);
+
+    return c->varCount++;
+}
+
+/** @brief Emit byte and track stack depth */
+static void _emit(CLI_VmComp_t* c, uint8_t byte)
+{
+    if (c->pc >= c->size) {
+        _error(c, "out of code memory");
+        return;
+    }
+
+    c->code[c->pc++] = byte;
+}
+
+static void _emit16(CLI_VmComp_t* c, uint16_t value)
+{
+    _emit(c, (uint8_t) value);
+    _emit(c, (uint8_t) (value >> 8));
+}
+
+static void _patch16(CLI_VmComp_t* c, uint16_t addr, uint16_t value)
+{
+    if (c->err != NULL)
+        return;
+
+    c->code[addr] = (uint8_t) value;
+    c->code[addr + 1] = (uint8_t) (value >> 8);
+}
+
+/** @brief Emit instruction, delta - change of stack depth */
+static void _emit_op(CLI_VmComp_t* c, uint8_t op, int8_t delta)
+{
+    _emit(c, op);
+
+    c->sp += delta;
+    if (c->sp > CLI_VM_STACK_SIZE)
+        _error(c, "expression too complex");
+}
+
+/** @brief Emit jump, return address of operand */
+static uint16_t _emit_jump(CLI_VmComp_t* c, uint8_t op, uint16_t addr)
+{
+    _emit_op(c, op, (op == OP_JZ) ? -1 : 0);
+
+    uint16_t operand = c->pc;
+    _emit16(c, addr);
+
+    return operand;
+}
+
+static void _emit_push(CLI_VmComp_t* c, int32_t value)
+{
+    if ((value >= INT8_MIN) && (value <= INT8_MAX)) {
+        _emit_op(c, OP_PUSH8, 1);
+        _emit(c, (uint8_t) value);
+        return;
+    }
+
+    _emit_op(c, OP_PUSH32, 1);
+    for (uint8_t i = 0; i < 4; i++)
+        _emit(c, (uint8_t) ((uint32_t) value >> (i * 8)));
+}
+
+static void _expr(CLI_VmComp_t* c, uint8_t minPrec);
+
+/** @brief Operand: number, variable, ( expr ) or unary operation */
+static void _unary(CLI_VmComp_t* c)
+{
+    if (c->err != NULL)
+        return;
+
+    if (_accept(c, "-")) {
+        _unary(c);
+        _emit_op(c, OP_NEG, 0);
+    } else if (_accept(c, "!")) {
+        _unary(c);
+        _emit_op(c, OP_NOT, 0);
+    } else if (_accept(c, "~")) {
+        _unary(c);
+        _emit_op(c, OP_INV, 0);
+    } else if (_accept(c, "(")) {
+        _expr(c, 1);
+        _expect(c, ")");
+    } else if (_is_digit(*c->p)) {
+        uint32_t value = 0;
+
+        if ((c->p[0] == '0') && ((c->p[1] == 'x') || (c->p[1] == 'X'))) {
+            c->p += 2;
+            for (;; c->p++) {
+                char ch = *c->p;
+
+                if (_is_digit(ch))
+                    value = (value << 4) | (uint32_t) (ch - '0');
+                else if (((ch | 0x20) >= 'a') && ((ch | 0x20) <= 'f'))
+                    value = (value << 4) | (uint32_t) ((ch | 0x20) - 'a' + 10);
+                else
+                    break;
+            }
+        } else {
+            while (_is_digit(*c->p))
+                value = value * 10 + (uint32_t) (*c->p++ - '0');
+        }
+
+        _emit_push(c, (int32_t) value);
+    } else if (_is_alpha(*c->p)) {
+        uint8_t id = _var(c, false);
+        _emit_op(c, OP_LOAD, 1);
+        _emit(c, id);
+    } else {
+        _error(c, "syntax error");
+    }
+}
+
+/** @brief Precedence climbing, binary operators with precedence >= minPrec */
+static void _expr(CLI_VmComp_t* c, uint8_t minPrec)
+{
+    _unary(c);
+
+    while (c->err == NULL) {
+        uint8_t i;
+
+        _skip_spaces(c);
+        for (i = 0; i < sizeof(_binOps) / sizeof(_binOps[0]); i++) {
+            uint8_t len = (_binOps[i].str[1] == '\0') ? 1 : 2;
+
+            if (_match(c->p, _binOps[i].str, len))
+                break;
+        }
+
+        if ((i == sizeof(_binOps) / sizeof(_binOps[0])) || (_binOps[i].prec < minPrec))
+            return;
+
+        c->p += (_binOps[i].str[1] == '\0') ? 1 : 2;
+        _expr(c, _binOps[i].prec + 1);
+        _emit_op(c, _binOps[i].op, -1);
+    }
+}
+
+/** @brief "call" template: rest of line, $var replaced by CALL_VAR index */
+static void _call(CLI_VmComp_t* c)
+{
+    _emit_op(c, OP_CALL, 0);
+    uint16_t lenAddr = c->pc;
+    _emit(c, 0);
+
+    _skip_spaces(c);
+    while ((*c->p != '\0') && (*c->p != '\n') && (*c->p != '\r') && (c->err == NULL)) {
+        if (*c->p == '$') {
+            c->p++;
+            uint8_t id = _var(c, false);
+            _emit(c, CALL_VAR);
+            _emit(c, id);
+        } else {
+            _emit(c, (uint8_t) *c->p++);
+        }
+    }
+
+    // trim trailing spaces
+    while ((c->pc > lenAddr + 1) && (c->code[c->pc - 1] == ' '))
+        c->pc--;
+
+    if ((c->pc - lenAddr - 1) > CLI_CMD_BUF_SIZE) {
+        _error(c, "command too long");
+        return;
+    }
+
+    if (c->pc == lenAddr + 1)
+        _error(c, "expected command");
+
+    if (c->err == NULL)
+        c->code[lenAddr] = (uint8_t) (c->pc - lenAddr - 1);
+}
+
+static void _open_block(CLI_VmComp_t* c, uint8_t type, uint8_t var, uint16_t loop, uint16_t patch)
+{
+    if (c->depth >= CLI_VM_MAX_DEPTH) {
+        _error(c, "too many nested blocks");
+        return;
+    }
+
+    c->blocks[c->depth].type = type;
+    c->blocks[c->depth].var = var;
+    c->blocks[c->depth].loop = loop;
+    c->blocks[c->depth].patch = patch;
+    c->depth++;
+}
+
+static void _end_block(CLI_VmComp_t* c)
+{
+    if (c->depth == 0) {
+        _error(c, "\"end\" without block");
+        return;
+    }
+
+    c->depth--;
+    uint8_t type = c->blocks[c->depth].type;
+    uint8_t var = c->blocks[c->depth].var;
+
+    if (type == BLOCK_FOR) {
+        _emit_op(c, OP_LOAD, 1);
+        _emit(c, var);
+        _emit_push(c, 1);
+        _emit_op(c, OP_ADD, -1);
+        _emit_op(c, OP_STORE, -1);
+        _emit(c, var);
+    }
+
+    if ((type == BLOCK_WHILE) || (type == BLOCK_FOR))
+        _emit_jump(c, OP_JMP, c->blocks[c->depth].loop);
+
+    _patch16(c, c->blocks[c->depth].patch, c->pc);
+}
+
+/** @brief Compile one line */
+static void _statement(CLI_VmComp_t* c)
+{
+    char word[CLI_VM_NAME_SIZE + 1];
+    const char* start;
+
+    if (_is_eol(c))
+        return;
+
+    start = c->p;
+    if (_ident(c, word) == 0) {
+        _error(c, "syntax error");
+        return;
+    }
+
+    if (_strcmp(word, "if")) {
+        _expr(c, 1);
+        _open_block(c, BLOCK_IF, 0, 0, _emit_jump(c, OP_JZ, 0));
+    } else if (_strcmp(word, "else")) {
+        if ((c->depth == 0) || (c->blocks[c->depth - 1].type != BLOCK_IF)) {
+            _error(c, "\"else\" without \"if\"");
+            return;
+        }
+        uint16_t patch = _emit_jump(c, OP_JMP, 0);
+        _patch16(c, c->blocks[c->depth - 1].patch, c->pc);
+        c->blocks[c->depth - 1].type = BLOCK_ELSE;
+        c->blocks[c->depth - 1].patch = patch;
+    } else if (_strcmp(word, "while")) {
+        uint16_t loop = c->pc;
+        _expr(c, 1);
+        _open_block(c, BLOCK_WHILE, 0, loop, _emit_jump(c, OP_JZ, 0));
+    } else if (_strcmp(word, "for")) {
+        uint8_t id = _var(c, true);
+        _expect(c, "=");
+        _expr(c, 1);
+        _emit_op(c, OP_STORE, -1);
+        _emit(c, id);
+
+        uint16_t loop = c->pc;
+        _emit_op(c, OP_LOAD, 1);
+        _emit(c, id);
+        if (_ident(c, word) == 0 || !_strcmp(word, "to"))
+            _error(c, "expected \"to\"");
+        _expr(c, 1);
+        _emit_op(c, OP_LE, -1);
+        _open_block(c, BLOCK_FOR, id, loop, _emit_jump(c, OP_JZ, 0));
+    } else if (_strcmp(word, "end")) {
+        _end_block(c);
+    } else if (_strcmp(word, "call")) {
+        _call(c);
+    } else if (_strcmp(word, "print")) {
+        _expr(c, 1);
+        _emit_op(c, OP_PRINT, -1);
+    } else if (_strcmp(word, "sleep")) {
+        _expr(c, 1);
+        _emit_op(c, OP_SLEEP, -1);
+    } else if (_strcmp(word, "stop")) {
+        _emit_op(c, OP_HALT, 0);
+    } else {
+        // "let <var> = <expr>" or "<var> = <expr>"
+        if (!_strcmp(word, "let"))
+            c->p = start;
+
+        uint8_t id = _var(c, true);
+        if (_accept(c, "==") || !_accept(c, "="))
+            _error(c, "syntax error");
+        _expr(c, 1);
+        _emit_op(c, OP_STORE, -1);
+        _emit(c, id);
+    }
+
+    if (!_is_eol(c))
+        _error(c, "unexpected text");
+}
+
+void cli_vm_init(void)
+{
+    CLI_Vm_s.used = 0;
+    CLI_Vm_s.countProgs = 0;
+    CLI_Vm_s.current = NULL;
+
+    for (uint8_t i = 0; i < CLI_VM_MAX_RUN; i++)
+        CLI_Vm_s.runs[i].active = false;
+}
+
+static const CLI_VmProg_t* _find_prog(const char* name)
+{
+    for (uint8_t i = 0; i < CLI_Vm_s.countProgs; i++) {
+        if (_strcmp(CLI_Vm_s.progs[i].name, name))
+            return &CLI_Vm_s.progs[i];
+    }
+
+    return NULL;
+}
+
+bool cli_vm_add(const char* name, const char* src)
+{
+    CLI_VmComp_t c;
+    uint16_t line = 0;
+
+    if ((name == NULL) || (src == NULL) || (_find_prog(name) != NULL) ||
+        (CLI_Vm_s.countProgs >= CLI_VM_MAX_PROGS))
+        return false;
+
+    c.err = NULL;
+    c.code = &CLI_Vm_s.code[CLI_Vm_s.used];
+    c.size = CLI_VM_CODE_SIZE - CLI_Vm_s.used;
+    c.pc = 0;
+    c.sp = 0;
+    c.depth = 0;
+    c.varCount = 2;
+    _strcpy("rc", 0, c.names[VAR_RC], 0, 3);
+    _strcpy("ret", 0, c.names[VAR_RET], 0, 4);
+
+    c.p = src;
+    while ((*c.p != '\0') && (c.err == NULL)) {
+        line++;
+        _statement(&c);
+
+        while ((*c.p != '\0') && (*c.p != '\n'))
+            c.p++;
+        if (*c.p == '\n')
+            c.p++;
+    }
+
+    if ((c.err == NULL) && (c.depth != 0))
+        _error(&c, "missing \"end\"");
+
+    _emit_op(&c, OP_HALT, 0);
+
+    if (c.err != NULL) {
+        CLI_PRINTF("\r\nvm %s: line %u: %s", name, (unsigned int) line, c.err);
+        return false;
+    }
+
+    CLI_VmProg_t* prog = &CLI_Vm_s.progs[CLI_Vm_s.countProgs++];
+    prog->name = name;
+    prog->offset = CLI_Vm_s.used;
+    prog->len = c.pc;
+    CLI_Vm_s.used += c.pc;
+
+    return true;
+}
+
+// ****************************** interpreter *****************************
+
+CLI_Result_t cli_vm_start(const char* name)
+{
+    const CLI_VmProg_t* prog = _find_prog(name);
+
+    if (prog == NULL)
+        return CLI_NotFound;
+
+    for (uint8_t i = 0; i < CLI_VM_MAX_RUN; i++) {
+        CLI_VmRun_t* r = &CLI_Vm_s.runs[i];
+
+        if (r->active)
+            continue;
+
+        cli_memset(r->vars, 0, sizeof(r->vars));
+        r->prog = prog;
+        r->pc = 0;
+        r->sp = 0;
+        r->step = 0;
+        r->sleeping = false;
+        r->active = true;
+
+        return CLI_OK;
+    }
+
+    return CLI_ExecErr;
+}
+
+void cli_vm_stop_all(void)
+{
+    for (uint8_t i = 0; i < CLI_VM_MAX_RUN; i++)
+        CLI_Vm_s.runs[i].active = false;
+}
+
+uint8_t cli_vm_count(void)
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < CLI_VM_MAX_RUN; i++)
+        count += CLI_Vm_s.runs[i].active;
+
+    return count;
+}
+
+void cli_vm_set_ret(int32_t value)
+{
+    if (CLI_Vm_s.current != NULL)
+        CLI_Vm_s.current->vars[VAR_RET] = value;
+}
+
+/**
+ * @brief Build command from template and execute one step
+ * @return false - command not finished (CLI_Continue)
+ * @note command longer than CLI_CMD_BUF_SIZE is not executed, rc = CLI_ArgErr
+ * */
+static bool _call_step(CLI_VmRun_t* r, const uint8_t* tpl, uint8_t len)
+{
+    char buf[CLI_CMD_BUF_SIZE + 1];
+    uint8_t n = 0;
+    bool overflow = false;
+
+    for (uint8_t i = 0; i < len; i++) {
+        if (tpl[i] != CALL_VAR) {
+            if (n < CLI_CMD_BUF_SIZE)
+                buf[n++] = (char) tpl[i];
+            else
+                overflow = true;
+            continue;
+        }
+
+        char num[12];
+        int32_t value = r->vars[tpl[++i]];
+        uint32_t u = (value < 0) ? 0u - (uint32_t) value : (uint32_t) value;
+        uint8_t k = 0;
+
+        do {
+            num[k++] = (char) ('0' + u % 10);
+            u /= 10;
+        } while (u != 0);
+        if (value < 0)
+            num[k++] = '-';
+
+        while ((k > 0) && (n < CLI_CMD_BUF_SIZE))
+            buf[n++] = num[--k];
+        overflow |= (k > 0);
+    }
+    buf[n] = '\0';
+
+    if (overflow) {
+        CLI_PRINTF("\r\nvm %s: call longer than %u chars", r->prog->name, (unsigned int) CLI_CMD_BUF_SIZE);
+        r->vars[VAR_RC] = (int32_t) CLI_ArgErr;
+        r->step = 0;
+        return true;
+    }
+
+    if (r->step == 0) {
+        cli_memset(r->state, 0, CLI_JOB_STATE_SIZE);
+        r->vars[VAR_RET] = 0;
+    }
+
+    CLI_Vm_s.current = r;
+    CLI_Result_t result = cli_execute_step(buf, r->state, r->step);
+    CLI_Vm_s.current = NULL;
+
+    if (result == CLI_Continue) {
+        if (r->step < UINT16_MAX)
+            r->step++;
+        return false;
+    }
+
+    r->vars[VAR_RC] = (int32_t) result;
+    r->step = 0;
+
+    return true;
+}
+
+static int32_t _binary(uint8_t op, int32_t a, int32_t b, bool* fault)
+{
+    switch (op) {
+    case OP_MUL:  return (int32_t) ((uint32_t) a * (uint32_t) b);
+    case OP_DIV:
+    case OP_MOD:
+        if (b == 0) {
+            *fault = true;
+            return 0;
+        }
+        if (b == -1)    // INT32_MIN / -1
+            return (op == OP_DIV) ? (int32_t) (0u - (uint32_t) a) : 0;
+        return (op == OP_DIV) ? a / b : a % b;
+    case OP_ADD:  return (int32_t) ((uint32_t) a + (uint32_t) b);
+    case OP_SUB:  return (int32_t) ((uint32_t) a - (uint32_t) b);
+    case OP_SHL:  return (int32_t) ((uint32_t) a << (b & 31));
+    case OP_SHR:  return a >> (b & 31);
+    case OP_LT:   return a < b;
+    case OP_LE:   return a <= b;
+    case OP_GT:   return a > b;
+    case OP_GE:   return a >= b;
+    case OP_EQ:   return a == b;
+    case OP_NE:   return a != b;
+    case OP_AND:  return a & b;
+    case OP_XOR:  return a ^ b;
+    case OP_OR:   return a | b;
+    case OP_LAND: return (a != 0) && (b != 0);
+    default:      return (a != 0) || (b != 0);
+    }
+}
+
+/**
+ * @brief Execute up to CLI_VM_BUDGET instructions
+ * @return NULL - program running, else reason of stop
+ * */
+static const char* _run(CLI_VmRun_t* r)
+{
+    const uint8_t* code = &CLI_Vm_s.code[r->prog->offset];
+    int32_t* st = r->stack;
+
+    if (r->sleeping) {
+        if ((int32_t) (CLI_GETMS() - r->wakeMs) < 0)
+            return NULL;
+        r->sleeping = false;
+    }
+
+    for (uint16_t budget = CLI_VM_BUDGET; budget != 0; budget--) {
+        uint8_t op = code[r->pc];
+
+        switch (op) {
+        case OP_HALT:
+            r->active = false;
+            return "done";
+        case OP_PUSH8:
+            st[r->sp++] = (int8_t) code[r->pc + 1];
+            r->pc += 2;
+            break;
+        case OP_PUSH32:
+            st[r->sp++] = (int32_t) ((uint32_t) code[r->pc + 1] | ((uint32_t) code[r->pc + 2] << 8) |
+                                     ((uint32_t) code[r->pc + 3] << 16) | ((uint32_t) code[r->pc + 4] << 24));
+            r->pc += 5;
+            break;
+        case OP_LOAD:
+            st[r->sp++] = r->vars[code[r->pc + 1]];
+            r->pc += 2;
+            break;
+        case OP_STORE:
+            r->vars[code[r->pc + 1]] = st[--r->sp];
+            r->pc += 2;
+            break;
+        case OP_JZ:
+            if (st[--r->sp] != 0) {
+                r->pc += 3;
+                break;
+            }
+            // fall through
+        case OP_JMP:
+            r->pc = code[r->pc + 1] | ((uint16_t) code[r->pc + 2] << 8);
+            break;
+        case OP_CALL:
+            if (!_call_step(r, &code[r->pc + 2], code[r->pc + 1]))
+                return NULL;
+            if (!r->active)             // stopped by called command
+                return "stopped";
+            r->pc += 2 + code[r->pc + 1];
+            break;
+        case OP_PRINT:
+            CLI_PRINTF("\r\n%d", (int) st[--r->sp]);
+            r->pc++;
+            break;
+        case OP_SLEEP:
+            r->wakeMs = CLI_GETMS() + (uint32_t) st[--r->sp];
+            r->sleeping = true;
+            r->pc++;
+            return NULL;
+        case OP_NEG:
+            st[r->sp - 1] = (int32_t) (0u - (uint32_t) st[r->sp - 1]);
+            r->pc++;
+            break;
+        case OP_NOT:
+            st[r->sp - 1] = !st[r->sp - 1];
+            r->pc++;
+            break;
+        case OP_INV:
+            st[r->sp - 1] = ~st[r->sp - 1];
+            r->pc++;
+            break;
+        default: {
+            bool fault = false;
+
+            r->sp--;
+            st[r->sp - 1] = _binary(op, st[r->sp - 1], st[r->sp], &fault);
+            if (fault) {
+                r->active = false;
+                return "division by zero";
+            }
+            r->pc++;
+            break;
+        }
+        }
+    }
+
+    return NULL;
+}
+
+bool cli_vm_service(void)
+{
+    bool finished = false;
+
+    for (uint8_t i = 0; i < CLI_VM_MAX_RUN; i++) {
+        CLI_VmRun_t* r = &CLI_Vm_s.runs[i];
+
+        if (!r->active)
+            continue;
+
+        const char* reason = _run(r);
+        if (reason != NULL) {
+            CLI_PRINTF("\r\nvm %s: %s", r->prog->name, reason);
+            finished = true;
+        }
+    }
+
+    return finished;
+}
+
+void cli_vm_print(void)
+{
+    CLI_PRINTF("\r\n%-10s %6s  %s", "program", "bytes", "state");
+
+    for (uint8_t i = 0; i < CLI_Vm_s.countProgs; i++) {
+        const CLI_VmProg_t* prog = &CLI_Vm_s.progs[i];
+        const CLI_VmRun_t* run = NULL;
+
+        for (uint8_t k = 0; k < CLI_VM_MAX_RUN; k++) {
+            if (CLI_Vm_s.runs[k].active && (CLI_Vm_s.runs[k].prog == prog))
+                run = &CLI_Vm_s.runs[k];
+        }
+
+        CLI_PRINTF("\r\n%-10s %6u  ", prog->name, (unsigned int) prog->len);
+        if (run != NULL)
+            CLI_PRINTF("run (pc %u)", (unsigned int) run->pc)
+        else
+            CLI_PRINTF("-")
+    }
+
+    CLI_PRINTF("\r\ncode %u/%u bytes", (unsigned int) CLI_Vm_s.used, (unsigned int) CLI_VM_CODE_SIZE);
+}
+
+uint32_t cli_vm_get_ram_size(void)
+{
+    return sizeof(CLI_Vm_s);
+}
+
+#endif // CLI_VM_EN == 1
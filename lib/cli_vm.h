@@ -0,0 +1,86 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+#ifndef _CLI_VM_H_
+#define _CLI_VM_H_
+
+#include "cli_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Script language, one statement per line, '#' - comment:
+ *
+ *   let <var> = <expr>         or  <var> = <expr>
+ *   if <expr> / else / end
+ *   while <expr> / end
+ *   for <var> = <expr> to <expr> / end     (inclusive, step 1)
+ *   call <cmd args $var ...>   execute CLI command, $var replaced by value,
+ *                              result in "rc", value from cli_vm_set_ret() in "ret",
+ *                              CLI_ArgErr without execution if longer than CLI_CMD_BUF_SIZE
+ *   print <expr>
+ *   sleep <expr>               pause program for <expr> ms
+ *   stop
+ *
+ * Expressions: 32-bit integers (dec, 0x hex), variables, ( ), unary - ! ~,
+ * * / % + - << >> < <= > >= == != & ^ | && ||
+ */
+
+/** @brief Init scripting engine */
+void cli_vm_init(void);
+
+/**
+ * @brief Compile script to bytecode and register program
+ * @param name - program name, must be valid while registered
+ * @param src - script text, '\0' terminated
+ * @return true if compiled, false - error printed
+ * */
+bool cli_vm_add(const char* name, const char* src);
+
+/**
+ * @brief Start program
+ * @param name - program name
+ * @return CLI_OK, CLI_NotFound - no program, CLI_ExecErr - no free run slot
+ * */
+CLI_Result_t cli_vm_start(const char* name);
+
+/** @brief Stop all running programs */
+void cli_vm_stop_all(void);
+
+/** @brief Count running programs */
+uint8_t cli_vm_count(void);
+
+/**
+ * @brief Execute running programs within CLI_VM_BUDGET instructions, call from cli_loop_service
+ * @return true if some program finished
+ * */
+bool cli_vm_service(void);
+
+/** @brief Set value of "ret" variable, call from command handler called by script */
+void cli_vm_set_ret(int32_t value);
+
+/** @brief Print programs and running state */
+void cli_vm_print(void);
+
+/** @brief Size of static state in bytes, "mem" command */
+uint32_t cli_vm_get_ram_size(void);
+
+#endif // _CLI_VM_H_
@@ -0,0 +1,229 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#define _GNU_SOURCE
+
+#include "cli_port_posix.h"
+#include "cli.h"
+#include "cli_rpc.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RX_BUF_SIZE         (64)                // chars read by one syscall
+
+static struct{
+    int rxFd;                                   // stdin or pty master
+    int txFd;                                   // stdout or pty master
+    int ptySlaveFd;                             // kept open, master does not get EIO without terminal program
+    bool isTty;                                 // input is terminal, '\r' is Enter
+    bool rawTty;                                // stdin switched to raw mode
+    struct termios savedTio;                    // stdin mode before raw
+    volatile bool open;                         // input not closed
+    volatile bool tickRun;
+    pthread_t tickThread;
+    uint8_t rx[RX_BUF_SIZE];
+    uint8_t rxHead;
+    uint8_t rxCount;
+}CLI_Posix_s = {0, 1, -1, false, false, {0}, true, false, 0, {0}, 0, 0};
+
+/** @brief Call SysTick_CLI with CLI_TICK_FREQ_HZ on absolute monotonic time, late ticks are caught up */
+static void* _tick_thread(void* arg)
+{
+    const long periodNs = 1000000000L / CLI_TICK_FREQ_HZ;
+    struct timespec next;
+
+    (void) arg;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (CLI_Posix_s.tickRun) {
+        next.tv_nsec += periodNs;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+            ;
+
+        SysTick_CLI();
+    }
+
+    return NULL;
+}
+
+/** @brief Raw mode of stdin: no line buffering, no echo, Ctrl+C comes as char */
+static void _set_raw_tty(void)
+{
+    struct termios tio;
+
+    if (tcgetattr(CLI_Posix_s.rxFd, &CLI_Posix_s.savedTio) != 0)
+        return;
+
+    tio = CLI_Posix_s.savedTio;
+    tio.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+    tio.c_iflag &= ~(ICRNL | INLCR | IXON);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+
+    if (tcsetattr(CLI_Posix_s.rxFd, TCSANOW, &tio) == 0)
+        CLI_Posix_s.rawTty = true;
+}
+
+const char* cli_port_posix_open_pty(void)
+{
+    struct termios tio;
+    const char* name;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+        return NULL;
+
+    if ((grantpt(fd) != 0) || (unlockpt(fd) != 0) || ((name = ptsname(fd)) == NULL)) {
+        close(fd);
+        return NULL;
+    }
+
+    CLI_Posix_s.ptySlaveFd = open(name, O_RDWR | O_NOCTTY);
+    if ((CLI_Posix_s.ptySlaveFd >= 0) && (tcgetattr(CLI_Posix_s.ptySlaveFd, &tio) == 0)) {
+        cfmakeraw(&tio);
+        tcsetattr(CLI_Posix_s.ptySlaveFd, TCSANOW, &tio);
+    }
+
+    CLI_Posix_s.rxFd = fd;
+    CLI_Posix_s.txFd = fd;
+    CLI_Posix_s.isTty = true;
+
+    return name;
+}
+
+void cli_port_init(void)
+{
+    if (CLI_Posix_s.rxFd == STDIN_FILENO) {
+        CLI_Posix_s.isTty = isatty(STDIN_FILENO);
+        if (CLI_Posix_s.isTty)
+            _set_raw_tty();
+    }
+
+    if (!CLI_Posix_s.tickRun) {
+        CLI_Posix_s.tickRun = true;
+        if (pthread_create(&CLI_Posix_s.tickThread, NULL, _tick_thread, NULL) != 0)
+            CLI_Posix_s.tickRun = false;
+    }
+}
+
+void cli_port_posix_close(void)
+{
+    if (CLI_Posix_s.tickRun) {
+        CLI_Posix_s.tickRun = false;
+        pthread_join(CLI_Posix_s.tickThread, NULL);
+    }
+
+    if (CLI_Posix_s.rawTty) {
+        tcsetattr(CLI_Posix_s.rxFd, TCSANOW, &CLI_Posix_s.savedTio);
+        CLI_Posix_s.rawTty = false;
+    }
+}
+
+void cli_port_get_uid(uint32_t uid[3])
+{
+    uid[0] = (uint32_t) gethostid();
+    uid[1] = (uint32_t) getuid();
+    uid[2] = (uint32_t) getpid();
+}
+
+/** Host has nothing to reset, stop main loop */
+void cli_port_reset(void)
+{
+    CLI_Posix_s.open = false;
+}
+
+void cli_port_delay_ms(uint32_t ms)
+{
+    struct timespec ts = {(time_t) (ms / 1000), (long) (ms % 1000) * 1000000L};
+
+    while (nanosleep(&ts, &ts) != 0 && (errno == EINTR))
+        ;
+}
+
+void cli_port_write(const char* str, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(CLI_Posix_s.txFd, str, len);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        str += n;
+        len -= (size_t) n;
+    }
+}
+
+int16_t cli_port_read(void)
+{
+    if (CLI_Posix_s.rxCount == 0) {
+        struct pollfd pfd = {CLI_Posix_s.rxFd, POLLIN, 0};
+
+        if (!CLI_Posix_s.open || (poll(&pfd, 1, 0) <= 0))
+            return -1;
+
+        ssize_t n = read(CLI_Posix_s.rxFd, CLI_Posix_s.rx, RX_BUF_SIZE);
+        if (n <= 0) {
+            if ((n == 0) || (errno != EINTR && errno != EAGAIN))
+                CLI_Posix_s.open = false;
+            return -1;
+        }
+
+        CLI_Posix_s.rxHead = 0;
+        CLI_Posix_s.rxCount = (uint8_t) n;
+    }
+
+    uint8_t c = CLI_Posix_s.rx[CLI_Posix_s.rxHead++];
+    CLI_Posix_s.rxCount--;
+
+    // line of pipe or file is ended by '\n', terminal sends '\r', frames of RPC mode are binary
+    if (!CLI_Posix_s.isTty && (c == '\n') && !cli_rpc_is_active())
+        c = '\r';
+
+    return c;
+}
+
+void cli_port_posix_wait(uint32_t ms)
+{
+    struct pollfd pfd = {CLI_Posix_s.rxFd, POLLIN, 0};
+
+    if ((CLI_Posix_s.rxCount == 0) && CLI_Posix_s.open)
+        poll(&pfd, 1, (int) ms);
+}
+
+bool cli_port_posix_is_open(void)
+{
+    return CLI_Posix_s.open;
+}
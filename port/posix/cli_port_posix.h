@@ -0,0 +1,43 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#ifndef _CLI_PORT_POSIX_H_
+#define _CLI_PORT_POSIX_H_
+
+#include "cli_port.h"
+
+/**
+ * @brief Use new pseudo-terminal instead of stdin/stdout, call before cli_init
+ * @return name of slave device for terminal program ("/dev/pts/N") or NULL
+ * */
+const char* cli_port_posix_open_pty(void);
+
+/** @brief Wait for input up to ms */
+void cli_port_posix_wait(uint32_t ms);
+
+/** @brief false after end of input or "reboot" */
+bool cli_port_posix_is_open(void);
+
+/** @brief Stop tick thread and restore terminal */
+void cli_port_posix_close(void);
+
+#endif // _CLI_PORT_POSIX_H_
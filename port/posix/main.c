@@ -0,0 +1,316 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#include "cli.h"
+#include "cli_port_posix.h"
+#include "cli_rec.h"
+#include "cli_rpc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static FILE* _recFile;
+
+static void _rec_write(const uint8_t* data, size_t len)
+{
+    fwrite(data, 1, len, _recFile);
+}
+
+/** @brief In-memory transport of load test: sends the same request, counts replies */
+typedef struct {
+    const char* open;                   // sent once before requests (switch of mode)
+    const uint8_t* req;                 // request
+    size_t reqLen;
+    const char* reply;                  // start of reply in output
+    size_t replyLen;
+    uint32_t expect;                    // replies of open
+    uint32_t left;                      // requests not sent
+    size_t pos;                         // sent bytes of current request
+    size_t match;                       // matched bytes of reply
+    uint32_t replies;
+    uint64_t rx;                        // bytes of replies
+} _LoadCtx_t;
+
+static void _load_write(void* ctx, const char* data, size_t len)
+{
+    _LoadCtx_t* c = (_LoadCtx_t*) ctx;
+
+    c->rx += len;
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == c->reply[c->match])
+            c->match++;
+        else
+            c->match = (data[i] == c->reply[0]) ? 1 : 0;
+
+        if (c->match == c->replyLen) {
+            c->match = 0;
+            c->replies++;
+        }
+    }
+}
+
+static size_t _load_read(void* ctx, char* buf, size_t size)
+{
+    _LoadCtx_t* c = (_LoadCtx_t*) ctx;
+    size_t n = 0;
+
+    // switch of mode ends block, like a client waits for reply of it
+    if (*c->open != '\0') {
+        while ((n < size) && (*c->open != '\0'))
+            buf[n++] = *c->open++;
+        return n;
+    }
+
+    while ((n < size) && (c->left > 0)) {
+        buf[n++] = (char) c->req[c->pos++];
+        if (c->pos == c->reqLen) {
+            c->pos = 0;
+            c->left--;
+        }
+    }
+
+    return n;
+}
+
+static const CLI_Transport_t _loadTransport = {_load_write, _load_read};
+static const CLI_Transport_t _pushTransport = {_load_write, NULL};      // input by cli_session_append_char
+
+static double _now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/** @brief Resumable command of load test: "steps <n>" returns after n loop passes */
+static CLI_Result_t _steps_cmd(void)
+{
+    return (cli_get_job_step() + 1U < cli_get_arg_dec(0)) ? CLI_Continue : CLI_OK;
+}
+
+/** @brief Client of push session sends next request after reply of previous one */
+static bool _load_waits(const _LoadCtx_t* c, uint32_t requests)
+{
+    return (*c->open == '\0') && (c->replies + c->left < requests + c->expect);
+}
+
+/** @brief Frame of RPC request "mr 20000000" */
+static size_t _load_rpc_frame(uint8_t* frame)
+{
+    uint8_t raw[10] = {1, 0, 0, CLI_RPC_ARG_HEX, 0x00, 0x00, 0x00, 0x20};
+    uint16_t id = 0;
+
+    while ((cli_get_cmd_name(id) != NULL) && (strcmp(cli_get_cmd_name(id), "mr") != 0))
+        id++;
+    raw[1] = (uint8_t) id;
+    raw[2] = (uint8_t) (id >> 8);
+
+    uint16_t crc = cli_rpc_crc16(raw, 8);
+    raw[8] = (uint8_t) crc;
+    raw[9] = (uint8_t) (crc >> 8);
+
+    size_t n = cli_rpc_cobs_encode(raw, sizeof(raw), frame);
+    frame[n++] = 0;
+
+    return n;
+}
+
+/**
+ * @brief Requests of all sessions served by one cli_loop_service loop, JSON result on stderr
+ * @param mixed - first session in machine mode ("steps 3", resumable), second in
+ *                RPC mode (both fed by cli_session_append_char between loop passes
+ *                and wait for reply of every request), others in text mode
+ * @return 0 - every session got reply of every request
+ * */
+static int _load(uint32_t sessions, uint32_t requests, bool mixed)
+{
+    static const char text[] = "mr 20000000\r";
+    static const char machine[] = "#1 steps 3\r";
+    static _LoadCtx_t ctx[CLI_SESSION_MAX];
+    static CLI_Session_t* session[CLI_SESSION_MAX];
+    static uint8_t frame[16];
+    uint32_t opened = 0;
+    uint32_t errors = 0;
+    uint64_t rx = 0;
+
+#if (CLI_RPC_EN == 0) || (CLI_MACHINE_EN == 0)
+    if (mixed) {
+        fprintf(stderr, "load: mixed needs CLI_RPC_EN and CLI_MACHINE_EN\n");
+        return 1;
+    }
+#endif
+#if (CLI_MEM_EN == 0)
+    fprintf(stderr, "load: requests \"mr\" need CLI_MEM_EN\n");
+    return 1;
+#endif
+
+    cli_init();
+    cli_add_new_cmd("steps", _steps_cmd, 1, CLI_PrintNone, "steps <n> resumable command of load test");
+    size_t frameLen = _load_rpc_frame(frame);
+
+    for (; (opened < sessions) && (opened < CLI_SESSION_MAX); opened++) {
+        _LoadCtx_t* c = &ctx[opened];
+
+        if (mixed && (opened == 0))
+            *c = (_LoadCtx_t) {"machine on\r", (const uint8_t*) machine, sizeof(machine) - 1, "#1 0\r\n", 6, 0};
+        else if (mixed && (opened == 1))
+            *c = (_LoadCtx_t) {CLI_RPC_ENTER_SEQ, frame, frameLen, "", 1, 2};     // 0x00 ends frame, hello
+        else
+            *c = (_LoadCtx_t) {"", (const uint8_t*) text, sizeof(text) - 1, "20000000: ", 10, 0};
+        c->left = requests;
+
+        session[opened] = cli_session_open((mixed && (opened < 2)) ? &_pushTransport : &_loadTransport, c);
+        if (session[opened] == NULL)
+            break;
+    }
+
+    double start = _now_s();
+    bool busy = true;
+    while (busy) {
+        // one request per pass fits into queue of machine mode and RPC mode
+        for (uint32_t i = 0; mixed && (i < opened) && (i < 2); i++) {
+            char buf[CLI_CMD_BUF_SIZE];
+
+            if (_load_waits(&ctx[i], requests))
+                continue;
+
+            size_t n = _load_read(&ctx[i], buf, ctx[i].reqLen);
+
+            for (size_t k = 0; k < n; k++)
+                cli_session_append_char(session[i], buf[k]);
+        }
+
+        cli_loop_service();
+        busy = false;
+        for (uint32_t i = 0; i < opened; i++)
+            busy |= (ctx[i].left > 0) || (mixed && (i < 2) && _load_waits(&ctx[i], requests));
+    }
+    // commands of the last requests
+    while (cli_loop_service())
+        ;
+    double time = _now_s() - start;
+
+    for (uint32_t i = 0; i < opened; i++) {
+        rx += ctx[i].rx;
+        if (ctx[i].replies != requests + ctx[i].expect)
+            errors++;
+    }
+
+    fprintf(stderr, "{\n"
+                    "  \"sessions\": %u,\n"
+                    "  \"mode\": \"%s\",\n"
+                    "  \"requests\": %llu,\n"
+                    "  \"time_s\": %.3f,\n"
+                    "  \"per_sec\": %.0f,\n"
+                    "  \"reply_bytes\": %llu,\n"
+                    "  \"sessions_with_lost_replies\": %u\n"
+                    "}\n",
+            (unsigned int) opened, mixed ? "mixed" : "text", (unsigned long long) opened * requests, time,
+            (double) opened * requests / time, (unsigned long long) rx, (unsigned int) errors);
+
+    return ((opened == sessions) && (errors == 0)) ? 0 : 1;
+}
+
+/*
+ * Host CLI:
+ *   cli_host                   - stdin/stdout (terminal or pipe)
+ *   cli_host --pty             - new pseudo-terminal, connect with "picocom /dev/pts/N"
+ *   cli_host --record <file>   - also record input with tick timestamps, see bench/cli_replay
+ *   cli_host --footprint       - print RAM of CLI subsystems for this configuration
+ *   cli_host --load <n> [<r>] [mixed]
+ *                              - n in-memory sessions send r requests each, print throughput,
+ *                                "mixed": first session in machine mode, second in RPC mode
+ */
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pty") == 0) {
+            const char* name = cli_port_posix_open_pty();
+
+            if (name == NULL) {
+                perror("pty");
+                return 1;
+            }
+            fprintf(stderr, "CLI on %s\n", name);
+        }
+        else if (strcmp(argv[i], "--footprint") == 0) {
+#if (CLI_MEM_STAT_EN == 1)
+            cli_print_footprint();
+            CLI_PrintStr("\r\n");
+#else
+            fprintf(stderr, "footprint: CLI_MEM_STAT_EN is 0\n");
+#endif
+            return 0;
+        }
+        else if ((strcmp(argv[i], "--load") == 0) && (i + 1 < argc)) {
+            uint32_t sessions = (uint32_t) strtoul(argv[i + 1], NULL, 10);
+            uint32_t requests = (i + 2 < argc) ? (uint32_t) strtoul(argv[i + 2], NULL, 10) : 10000;
+            bool mixed = (i + 3 < argc) && (strcmp(argv[i + 3], "mixed") == 0);
+
+            return _load(sessions, requests, mixed);
+        }
+        else if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc)) {
+            _recFile = fopen(argv[++i], "wb");
+            if (_recFile == NULL) {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else {
+            fprintf(stderr, "usage: %s [--pty] [--record <file>] [--footprint] [--load <sessions> [<requests> [mixed]]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    cli_init();
+
+    if (_recFile != NULL)
+        cli_rec_start(_rec_write);
+
+    while (cli_port_posix_is_open()) {
+        int16_t c;
+
+        // execute every line, input of pipe comes in blocks
+        while ((c = cli_port_read()) >= 0) {
+            if (cli_append_char((char) c) == CLI_APPEND_Enter)
+                cli_loop_service();
+        }
+
+        cli_loop_service();
+        cli_port_posix_wait(1);
+    }
+
+    // finish commands and jobs of the last input line
+    cli_loop_service();
+    CLI_PrintStr("\r\n");
+
+    if (_recFile != NULL) {
+        cli_rec_stop();
+        fclose(_recFile);
+    }
+
+    cli_port_posix_close();
+    return 0;
+}
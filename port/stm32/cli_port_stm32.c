@@ -0,0 +1,65 @@
+/**
+ * @brief Compact & Simple Command Line Interface for microcontrollers
+ *
+ * Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * */
+
+
+
+#include "cli_port.h"
+#include "cli.h"
+#include "main.h"       // STM32Cube project header, includes HAL of MCU
+
+// need change address for another MCU, see datasheet for MCU (for stm32f4 0x1FFF7A10, stm32F1 0x1FFFF7E8) or another MCU
+#define UID_BASE_ADDR       (0x1FFF7A10UL)
+
+/** SysTick_CLI() is called from SysTick_Handler (HAL_SYSTICK_Callback) */
+void cli_port_init(void)
+{
+}
+
+void cli_port_get_uid(uint32_t uid[3])
+{
+    volatile const uint32_t* id = (volatile const uint32_t*) UID_BASE_ADDR;
+
+    uid[0] = id[0];
+    uid[1] = id[1];
+    uid[2] = id[2];
+}
+
+void cli_port_reset(void)
+{
+    HAL_NVIC_SystemReset();
+}
+
+void cli_port_delay_ms(uint32_t ms)
+{
+    HAL_Delay(ms);
+}
+
+/** Your implementation of sending to IO stream, e.g. HAL_UART_Transmit */
+void cli_port_write(const char* str, size_t len)
+{
+    (void) str;
+    (void) len;
+}
+
+/** RX in interrupt: call CLI_AppendChar(c) for every received char */
+int16_t cli_port_read(void)
+{
+    return -1;
+}
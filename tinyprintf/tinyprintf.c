@@ -32,6 +32,8 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <limits.h>
+#include <string.h>
 
 #include "tinyprintf.h"
 #ifdef PRINTF_USB
@@ -53,6 +55,9 @@
 #ifndef PRINTF_NTOA_BUFFER_SIZE
 #define PRINTF_NTOA_BUFFER_SIZE    32U
 #endif
+#if (PRINTF_NTOA_BUFFER_SIZE < 20U)
+#error "PRINTF_NTOA_BUFFER_SIZE must hold 20 decimal digits"
+#endif
 
 // 'ftoa' conversion buffer size, this must be big enough to hold one converted
 // float number including padded zeros (dynamically created on stack)
@@ -67,6 +72,11 @@
 #define PRINTF_SUPPORT_FLOAT
 #endif
 
+// define this globally (e.g. gcc -DPRINTF_FLOAT_SINGLE ...) to format %f with
+// single precision using integer arithmetic only, no double math routines are
+// linked for %f (define PRINTF_DISABLE_SUPPORT_EXPONENTIAL too to remove all)
+// default: undefined
+
 // support for exponential floating point notation (%e/%g)
 // default: activated
 #ifndef PRINTF_DISABLE_SUPPORT_EXPONENTIAL
@@ -101,17 +111,17 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 // internal flag definitions
-#define FLAGS_ZEROPAD   (1U <<  0U)
-#define FLAGS_LEFT      (1U <<  1U)
-#define FLAGS_PLUS      (1U <<  2U)
-#define FLAGS_SPACE     (1U <<  3U)
-#define FLAGS_HASH      (1U <<  4U)
-#define FLAGS_UPPERCASE (1U <<  5U)
+#define FLAGS_ZEROPAD   PRINTF_FLAG_ZEROPAD
+#define FLAGS_LEFT      PRINTF_FLAG_LEFT
+#define FLAGS_PLUS      PRINTF_FLAG_PLUS
+#define FLAGS_SPACE     PRINTF_FLAG_SPACE
+#define FLAGS_HASH      PRINTF_FLAG_HASH
+#define FLAGS_UPPERCASE PRINTF_FLAG_UPPERCASE
 #define FLAGS_CHAR      (1U <<  6U)
 #define FLAGS_SHORT     (1U <<  7U)
 #define FLAGS_LONG      (1U <<  8U)
 #define FLAGS_LONG_LONG (1U <<  9U)
-#define FLAGS_PRECISION (1U << 10U)
+#define FLAGS_PRECISION PRINTF_FLAG_PRECISION
 #define FLAGS_ADAPT_EXP (1U << 11U)
 
 
@@ -128,6 +138,7 @@ typedef void (*out_fct_type)(char character, void* buffer, size_t idx, size_t ma
 // wrapper (used as buffer) for output function type
 typedef struct {
     void  (*fct)(char character, void* arg);
+    void  (*blk)(const char* str, size_t len, void* arg);    // optional span output
     void* arg;
 } out_fct_wrap_type;
 
@@ -172,6 +183,43 @@ static inline void _out_fct(char character, void* buffer, size_t idx, size_t max
 }
 
 
+// internal span output
+// buffer output copies with memcpy, fctprintf_blk sinks get the whole span,
+// other outputs are called per character
+// \return index after the span
+static size_t _out_str(out_fct_type out, char* buffer, size_t idx, size_t maxlen, const char* str, size_t len)
+{
+    if (out == _out_buffer) {
+        if (idx < maxlen) {
+            memcpy(&buffer[idx], str, (len < maxlen - idx) ? len : maxlen - idx);
+        }
+    }
+    else if ((out == _out_fct) && ((out_fct_wrap_type*)buffer)->blk) {
+        ((out_fct_wrap_type*)buffer)->blk(str, len, ((out_fct_wrap_type*)buffer)->arg);
+    }
+    else if (out != _out_null) {
+        for (size_t i = 0U; i < len; i++) {
+            out(str[i], buffer, idx + i, maxlen);
+        }
+    }
+    return idx + len;
+}
+
+
+// internal output of count spaces
+static size_t _out_pad(out_fct_type out, char* buffer, size_t idx, size_t maxlen, size_t count)
+{
+    static const char spaces[16] = { ' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ' };
+
+    while (count) {
+        const size_t n = (count < sizeof(spaces)) ? count : sizeof(spaces);
+        idx = _out_str(out, buffer, idx, maxlen, spaces, n);
+        count -= n;
+    }
+    return idx;
+}
+
+
 // internal secure strlen
 // \return The length of the string (excluding the terminating 0) limited by 'maxsize'
 static inline unsigned int _strnlen_s(const char* str, size_t maxsize)
@@ -201,6 +249,7 @@ static unsigned int _atoi(const char** str)
 }
 
 
+#if defined(PRINTF_SUPPORT_FLOAT)
 // output the specified string in reverse, taking care of any zero-padding
 static size_t _out_rev(out_fct_type out, char* buffer, size_t idx, size_t maxlen, const char* buf, size_t len, unsigned int width, unsigned int flags)
 {
@@ -227,59 +276,167 @@ static size_t _out_rev(out_fct_type out, char* buffer, size_t idx, size_t maxlen
 
     return idx;
 }
+#endif  // PRINTF_SUPPORT_FLOAT
+
+
+// output the specified string forward, taking care of any zero-padding
+static size_t _out_fwd(out_fct_type out, char* buffer, size_t idx, size_t maxlen, const char* buf, size_t len, unsigned int width, unsigned int flags)
+{
+    // pad spaces up to given width
+    if (!(flags & FLAGS_LEFT) && !(flags & FLAGS_ZEROPAD) && (len < width)) {
+        idx = _out_pad(out, buffer, idx, maxlen, width - len);
+    }
+
+    idx = _out_str(out, buffer, idx, maxlen, buf, len);
+
+    // append pad spaces up to given width
+    if ((flags & FLAGS_LEFT) && (len < width)) {
+        idx = _out_pad(out, buffer, idx, maxlen, width - len);
+    }
+
+    return idx;
+}
 
 
 // internal itoa format
-static size_t _ntoa_format(out_fct_type out, char* buffer, size_t idx, size_t maxlen, char* buf, size_t len, bool negative, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags)
+// digits are stored forward at the end of buf, [p, buf + PRINTF_NTOA_BUFFER_SIZE),
+// padding and prefix are prepended before p
+static size_t _ntoa_format(out_fct_type out, char* buffer, size_t idx, size_t maxlen, char* buf, char* p, bool negative, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags)
 {
+    char* const end = buf + PRINTF_NTOA_BUFFER_SIZE;
+
     // pad leading zeros
     if (!(flags & FLAGS_LEFT)) {
         if (width && (flags & FLAGS_ZEROPAD) && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
             width--;
         }
-        while ((len < prec) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-            buf[len++] = '0';
+        while (((size_t)(end - p) < prec) && (p > buf)) {
+            *--p = '0';
         }
-        while ((flags & FLAGS_ZEROPAD) && (len < width) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-            buf[len++] = '0';
+        while ((flags & FLAGS_ZEROPAD) && ((size_t)(end - p) < width) && (p > buf)) {
+            *--p = '0';
         }
     }
 
     // handle hash
     if (flags & FLAGS_HASH) {
+        const size_t len = (size_t)(end - p);
         if (!(flags & FLAGS_PRECISION) && len && ((len == prec) || (len == width))) {
-            len--;
-            if (len && (base == 16U)) {
-                len--;
+            p++;
+            if ((p < end) && (base == 16U)) {
+                p++;
             }
         }
-        if ((base == 16U) && !(flags & FLAGS_UPPERCASE) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-            buf[len++] = 'x';
+        if ((base == 16U) && !(flags & FLAGS_UPPERCASE) && (p > buf)) {
+            *--p = 'x';
         }
-        else if ((base == 16U) && (flags & FLAGS_UPPERCASE) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-            buf[len++] = 'X';
+        else if ((base == 16U) && (flags & FLAGS_UPPERCASE) && (p > buf)) {
+            *--p = 'X';
         }
-        else if ((base == 2U) && (len < PRINTF_NTOA_BUFFER_SIZE)) {
-            buf[len++] = 'b';
+        else if ((base == 2U) && (p > buf)) {
+            *--p = 'b';
         }
-        if (len < PRINTF_NTOA_BUFFER_SIZE) {
-            buf[len++] = '0';
+        if (p > buf) {
+            *--p = '0';
         }
     }
 
-    if (len < PRINTF_NTOA_BUFFER_SIZE) {
+    if (p > buf) {
         if (negative) {
-            buf[len++] = '-';
+            *--p = '-';
         }
         else if (flags & FLAGS_PLUS) {
-            buf[len++] = '+';  // ignore the space if the '+' exists
+            *--p = '+';  // ignore the space if the '+' exists
         }
         else if (flags & FLAGS_SPACE) {
-            buf[len++] = ' ';
+            *--p = ' ';
         }
     }
 
-    return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
+    return _out_fwd(out, buffer, idx, maxlen, p, (size_t)(end - p), width, flags);
+}
+
+
+// decimal digit pairs "00".."99"
+static const char _digits2[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const char _digits16[2][16] = {
+    { '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' },
+    { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' }
+};
+
+
+// internal 32-bit itoa, writes digits backward from p, not below start
+// base 10 emits two digits per division, bases 2, 8 and 16 use shift and mask
+// \return pointer to the first digit
+static char* _utoa32(char* start, char* p, uint32_t value, unsigned int base, unsigned int flags)
+{
+    if (base == 10U) {
+        while (value >= 100U) {
+            const uint32_t q = value / 100U;
+            const uint32_t r = (value - q * 100U) * 2U;
+            *--p = _digits2[r + 1U];
+            *--p = _digits2[r];
+            value = q;
+        }
+        if (value >= 10U) {
+            *--p = _digits2[value * 2U + 1U];
+            *--p = _digits2[value * 2U];
+        }
+        else {
+            *--p = (char)('0' + value);
+        }
+        return p;
+    }
+
+    const char* digits = _digits16[(flags & FLAGS_UPPERCASE) ? 1U : 0U];
+    const unsigned int shift = (base == 16U) ? 4U : (base == 8U) ? 3U : 1U;
+    do {
+        *--p = digits[value & (base - 1U)];
+        value >>= shift;
+    } while (value && (p > start));
+
+    return p;
+}
+
+
+// internal 64-bit itoa, writes digits backward from p, not below start
+// base 10 splits the value in 9-digit chunks, so the 64-bit division runs at most twice
+// \return pointer to the first digit
+static char* _utoa64(char* start, char* p, unsigned long long value, unsigned int base, unsigned int flags)
+{
+    if (base != 10U) {
+        const char* digits = _digits16[(flags & FLAGS_UPPERCASE) ? 1U : 0U];
+        const unsigned int shift = (base == 16U) ? 4U : (base == 8U) ? 3U : 1U;
+        while ((value > 0xFFFFFFFFULL) && (p > start)) {
+            *--p = digits[(unsigned int)value & (base - 1U)];
+            value >>= shift;
+        }
+        return (p > start) ? _utoa32(start, p, (uint32_t)value, base, flags) : p;
+    }
+
+    while (value > 0xFFFFFFFFULL) {
+        const unsigned long long q = value / 1000000000ULL;
+        char* const chunk = p - 9;
+        p = _utoa32(start, p, (uint32_t)(value - q * 1000000000ULL), 10U, flags);
+        while (p > chunk) {
+            *--p = '0';
+        }
+        value = q;
+    }
+
+    return _utoa32(start, p, (uint32_t)value, 10U, flags);
 }
 
 
@@ -287,7 +444,7 @@ static size_t _ntoa_format(out_fct_type out, char* buffer, size_t idx, size_t ma
 static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxlen, unsigned long value, bool negative, unsigned long base, unsigned int prec, unsigned int width, unsigned int flags)
 {
     char buf[PRINTF_NTOA_BUFFER_SIZE];
-    size_t len = 0U;
+    char* p = buf + PRINTF_NTOA_BUFFER_SIZE;
 
     // no hash for 0 values
     if (!value) {
@@ -296,14 +453,18 @@ static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxl
 
     // write if precision != 0 and value is != 0
     if (!(flags & FLAGS_PRECISION) || value) {
-        do {
-            const char digit = (char)(value % base);
-            buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-            value /= base;
-        } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+#if (ULONG_MAX > 0xFFFFFFFFUL)
+        if (value > 0xFFFFFFFFUL) {
+            p = _utoa64(buf, p, value, (unsigned int)base, flags);
+        }
+        else
+#endif
+        {
+            p = _utoa32(buf, p, (uint32_t)value, (unsigned int)base, flags);
+        }
     }
 
-    return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
+    return _ntoa_format(out, buffer, idx, maxlen, buf, p, negative, (unsigned int)base, prec, width, flags);
 }
 
 
@@ -312,7 +473,7 @@ static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxl
 static size_t _ntoa_long_long(out_fct_type out, char* buffer, size_t idx, size_t maxlen, unsigned long long value, bool negative, unsigned long long base, unsigned int prec, unsigned int width, unsigned int flags)
 {
     char buf[PRINTF_NTOA_BUFFER_SIZE];
-    size_t len = 0U;
+    char* p = buf + PRINTF_NTOA_BUFFER_SIZE;
 
     // no hash for 0 values
     if (!value) {
@@ -321,18 +482,129 @@ static size_t _ntoa_long_long(out_fct_type out, char* buffer, size_t idx, size_t
 
     // write if precision != 0 and value is != 0
     if (!(flags & FLAGS_PRECISION) || value) {
-        do {
-            const char digit = (char)(value % base);
-            buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-            value /= base;
-        } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+        if (value > 0xFFFFFFFFULL) {
+            p = _utoa64(buf, p, value, (unsigned int)base, flags);
+        }
+        else {
+            p = _utoa32(buf, p, (uint32_t)value, (unsigned int)base, flags);
+        }
     }
 
-    return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
+    return _ntoa_format(out, buffer, idx, maxlen, buf, p, negative, (unsigned int)base, prec, width, flags);
 }
 #endif  // PRINTF_SUPPORT_LONG_LONG
 
 
+// internal fixed point to decimal, value is mag / 2^shift, integer arithmetic only
+// valid for shift <= 32, or for any shift if mag < 2^24 (single precision mantissa)
+static size_t _qtoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, unsigned long long mag, unsigned int shift, bool negative, unsigned int prec, unsigned int width, unsigned int flags)
+{
+    static const uint32_t pow10[] = { 1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U };
+    char buf[PRINTF_NTOA_BUFFER_SIZE];
+    char* p = buf + PRINTF_NTOA_BUFFER_SIZE;
+    unsigned long long whole = 0U;
+    uint32_t frac = 0U;
+    unsigned int extra = 0U;
+    unsigned long long rest = 0U;
+    unsigned int bits = 0U;
+    unsigned int last = 0U;
+    bool up = false;
+
+    // set default precision, if not set explicitly
+    if (!(flags & FLAGS_PRECISION)) {
+        prec = PRINTF_DEFAULT_FLOAT_PRECISION;
+    }
+    // 9 digits are formatted, further digits are written after the formatted number
+    if (prec > 9U) {
+        extra = prec - 9U;
+        prec = 9U;
+    }
+
+    // shift >= 64: value < 2^-40, all digits are zeros
+    if (shift < 64U) {
+        whole = mag >> shift;
+        if (shift) {
+            // the remainder is < 2^32 or < 2^24, so remainder * 10^9 fits 64 bits, round half up
+            const unsigned long long rem = mag & ((1ULL << shift) - 1U);
+            if (extra) {
+                // 9 digits are truncated, the rest of the fraction is rest / 2^bits
+                frac = (uint32_t)((rem * pow10[prec]) >> shift);
+                rest = (rem * pow10[prec]) & ((1ULL << shift) - 1U);
+                bits = shift;
+            }
+            else {
+                frac = (uint32_t)((rem * pow10[prec] + (1ULL << (shift - 1U))) >> shift);
+            }
+        }
+    }
+
+    // the binary fraction is finite, further digits are exact: rest * 10 / 2^bits is
+    // computed as rest * 5 / 2^(bits - 1), so it fits 64 bits for both valid ranges above
+    if (rest) {
+        unsigned long long r = rest;
+        unsigned int b = bits;
+        for (unsigned int i = 1U; (i <= extra) && r; i++) {
+            r *= 5U;
+            b--;
+            if ((r >> b) != 9U) {
+                last = i;
+            }
+            r &= (1ULL << b) - 1U;
+        }
+        // round half up, carry goes to the last digit which is not 9 (or to the first 9 digits)
+        up = r && ((r >> (b - 1U)) != 0U);
+        if (up && !last) {
+            frac++;
+        }
+    }
+
+    // handle rollover, e.g. 0.99 with prec 1 is 1.0
+    if (frac >= pow10[prec]) {
+        frac -= pow10[prec];
+        whole++;
+    }
+
+    if (prec) {
+        char* const stop = p - prec;
+        p = _utoa32(buf, p, frac, 10U, flags);
+        while (p > stop) {
+            *--p = '0';
+        }
+        *--p = '.';
+    }
+    p = (whole > 0xFFFFFFFFULL) ? _utoa64(buf, p, whole, 10U, flags) : _utoa32(buf, p, (uint32_t)whole, 10U, flags);
+
+    if (!extra) {
+        return _ntoa_format(out, buffer, idx, maxlen, buf, p, negative, 10U, 0U, width, flags & ~(FLAGS_HASH | FLAGS_PRECISION));
+    }
+
+    // right aligned number takes width without further digits, left aligned is padded after them
+    const size_t start_idx = idx;
+    const unsigned int num_width = (flags & FLAGS_LEFT) ? 0U : ((width > extra) ? width - extra : 0U);
+    idx = _ntoa_format(out, buffer, idx, maxlen, buf, p, negative, 10U, 0U, num_width, flags & ~(FLAGS_HASH | FLAGS_PRECISION));
+    for (unsigned int i = 1U; i <= extra; i++) {
+        unsigned int digit = 0U;
+        if (rest) {
+            rest *= 5U;
+            bits--;
+            digit = (unsigned int)(rest >> bits);
+            rest &= (1ULL << bits) - 1U;
+        }
+        if (up && (i >= last)) {
+            digit = (i == last) ? digit + 1U : 0U;
+        }
+        out((char)('0' + digit), buffer, idx++, maxlen);
+    }
+    if (flags & FLAGS_LEFT) {
+        while (idx - start_idx < width) {
+            out(' ', buffer, idx++, maxlen);
+        }
+    }
+
+    return idx;
+}
+
+
 #if defined(PRINTF_SUPPORT_FLOAT)
 
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
@@ -341,6 +613,54 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
 #endif
 
 
+#if defined(PRINTF_FLOAT_SINGLE)
+// internal ftoa with single precision and integer arithmetic only
+// the double is decoded to a 24-bit mantissa and binary exponent, then printed by _qtoa
+static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+{
+    union {
+        uint64_t U;
+        double   F;
+    } conv;
+
+    conv.F = value;
+    const bool negative = (conv.U >> 63U) != 0U;
+    const int exp2 = (int)((conv.U >> 52U) & 0x7FFU);
+    unsigned long long mant = conv.U & ((1ULL << 52U) - 1U);
+
+    // test for special values
+    if (exp2 == 0x7FF) {
+        if (mant)
+            return _out_rev(out, buffer, idx, maxlen, "nan", 3, width, flags);
+        if (negative)
+            return _out_rev(out, buffer, idx, maxlen, "fni-", 4, width, flags);
+        return _out_rev(out, buffer, idx, maxlen, (flags & FLAGS_PLUS) ? "fni+" : "fni", (flags & FLAGS_PLUS) ? 4U : 3U, width, flags);
+    }
+
+    // zero and subnormals
+    if (exp2 == 0) {
+        return _qtoa(out, buffer, idx, maxlen, 0U, 0U, negative && mant, prec, width, flags);
+    }
+
+    // round the 53-bit mantissa to 24 bits, value = mant * 2^e
+    mant = ((mant | (1ULL << 52U)) + (1ULL << 28U)) >> 29U;
+    const int e = exp2 - 1075 + 29;
+
+    // test for very large values
+    if ((e > 39) || ((e >= 0) && ((mant << e) > (unsigned long long)PRINTF_MAX_FLOAT))) {
+#if defined(PRINTF_SUPPORT_EXPONENTIAL)
+        return _etoa(out, buffer, idx, maxlen, value, prec, width, flags);
+#else
+        return idx;
+#endif
+    }
+
+    if (e >= 0) {
+        return _qtoa(out, buffer, idx, maxlen, mant << e, 0U, negative, prec, width, flags);
+    }
+    return _qtoa(out, buffer, idx, maxlen, mant, (unsigned int)-e, negative, prec, width, flags);
+}
+#else
 // internal ftoa for fixed decimal floating point
 static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
 {
@@ -466,6 +786,7 @@ static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
 
     return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
 }
+#endif  // PRINTF_FLOAT_SINGLE
 
 
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
@@ -594,9 +915,12 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
     {
         // format specifier?  %[flags][width][.precision][length]
         if (*format != '%') {
-            // no
-            out(*format, buffer, idx++, maxlen);
-            format++;
+            // no, output the run of literal text up to the next specifier
+            const char* run = format;
+            while (*format && (*format != '%')) {
+                format++;
+            }
+            idx = _out_str(out, buffer, idx, maxlen, run, (size_t)(format - run));
             continue;
         }
         else {
@@ -730,16 +1054,16 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
                     if (flags & FLAGS_LONG_LONG) {
 #if defined(PRINTF_SUPPORT_LONG_LONG)
                         const long long value = va_arg(va, long long);
-                        idx = _ntoa_long_long(out, buffer, idx, maxlen, (unsigned long long)(value > 0 ? value : 0 - value), value < 0, base, precision, width, flags);
+                        idx = _ntoa_long_long(out, buffer, idx, maxlen, (value > 0 ? (unsigned long long)value : 0ULL - (unsigned long long)value), value < 0, base, precision, width, flags);
 #endif
                     }
                     else if (flags & FLAGS_LONG) {
                         const long value = va_arg(va, long);
-                        idx = _ntoa_long(out, buffer, idx, maxlen, (unsigned long)(value > 0 ? value : 0 - value), value < 0, base, precision, width, flags);
+                        idx = _ntoa_long(out, buffer, idx, maxlen, (value > 0 ? (unsigned long)value : 0UL - (unsigned long)value), value < 0, base, precision, width, flags);
                     }
                     else {
                         const int value = (flags & FLAGS_CHAR) ? (char)va_arg(va, int) : (flags & FLAGS_SHORT) ? (short int)va_arg(va, int) : va_arg(va, int);
-                        idx = _ntoa_long(out, buffer, idx, maxlen, (unsigned int)(value > 0 ? value : 0 - value), value < 0, base, precision, width, flags);
+                        idx = _ntoa_long(out, buffer, idx, maxlen, (value > 0 ? (unsigned int)value : 0U - (unsigned int)value), value < 0, base, precision, width, flags);
                     }
                 }
                 else {
@@ -760,6 +1084,34 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
                 format++;
                 break;
             }
+            case 'q' : {
+                // fixed point Q format: %q<int bits>.<frac bits> or %q<frac bits>, raw value
+                // is int, long long if int + frac bits > 32 (or with l/ll length), frac bits <= 32
+                unsigned int ibits = 0U;
+                unsigned int fbits;
+                long long value;
+                format++;
+                fbits = _atoi(&format);
+                if (*format == '.') {
+                    format++;
+                    ibits = fbits;
+                    fbits = _atoi(&format);
+                }
+                if (fbits > 32U) {
+                    fbits = 32U;
+                }
+                if ((flags & FLAGS_LONG_LONG) || (ibits + fbits > 32U)) {
+                    value = va_arg(va, long long);
+                }
+                else if (flags & FLAGS_LONG) {
+                    value = va_arg(va, long);
+                }
+                else {
+                    value = va_arg(va, int);
+                }
+                idx = _qtoa(out, buffer, idx, maxlen, (value > 0 ? (unsigned long long)value : 0ULL - (unsigned long long)value), fbits, value < 0, precision, width, flags);
+                break;
+            }
 #if defined(PRINTF_SUPPORT_FLOAT)
             case 'f' :
             case 'F' :
@@ -806,20 +1158,14 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
                 if (flags & FLAGS_PRECISION) {
                     l = (l < precision ? l : precision);
                 }
-                if (!(flags & FLAGS_LEFT)) {
-                    while (l++ < width) {
-                        out(' ', buffer, idx++, maxlen);
-                    }
+                if (!(flags & FLAGS_LEFT) && (l < width)) {
+                    idx = _out_pad(out, buffer, idx, maxlen, width - l);
                 }
                 // string output
-                while ((*p != 0) && (!(flags & FLAGS_PRECISION) || precision--)) {
-                    out(*(p++), buffer, idx++, maxlen);
-                }
+                idx = _out_str(out, buffer, idx, maxlen, p, l);
                 // post padding
-                if (flags & FLAGS_LEFT) {
-                    while (l++ < width) {
-                        out(' ', buffer, idx++, maxlen);
-                    }
+                if ((flags & FLAGS_LEFT) && (l < width)) {
+                    idx = _out_pad(out, buffer, idx, maxlen, width - l);
                 }
                 format++;
                 break;
@@ -913,13 +1259,65 @@ int fctprintf(void (*out)(char character, void* arg), void* arg, const char* for
 {
     va_list va;
     va_start(va, format);
-    const out_fct_wrap_type out_fct_wrap = { out, arg };
+    const out_fct_wrap_type out_fct_wrap = { out, NULL, arg };
+    const int ret = _vsnprintf(_out_fct, (char*)(uintptr_t)&out_fct_wrap, (size_t)-1, format, va);
+    va_end(va);
+    return ret;
+}
+
+
+int fctprintf_blk(void (*out)(char character, void* arg), void (*out_blk)(const char* str, size_t len, void* arg), void* arg, const char* format, ...)
+{
+    va_list va;
+    va_start(va, format);
+    const out_fct_wrap_type out_fct_wrap = { out, out_blk, arg };
     const int ret = _vsnprintf(_out_fct, (char*)(uintptr_t)&out_fct_wrap, (size_t)-1, format, va);
     va_end(va);
     return ret;
 }
 
 
+size_t tinyprintf_ntoa(char* buffer, size_t idx, size_t maxlen, unsigned long long value, int negative, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags)
+{
+#if defined(PRINTF_SUPPORT_LONG_LONG)
+    if (value > ULONG_MAX) {
+        return _ntoa_long_long(_out_buffer, buffer, idx, maxlen, value, negative != 0, base, prec, width, flags);
+    }
+#endif
+    return _ntoa_long(_out_buffer, buffer, idx, maxlen, (unsigned long)value, negative != 0, base, prec, width, flags);
+}
+
+
+size_t tinyprintf_qtoa(char* buffer, size_t idx, size_t maxlen, long long value, unsigned int fbits, unsigned int prec, unsigned int width, unsigned int flags)
+{
+    return _qtoa(_out_buffer, buffer, idx, maxlen, (value > 0 ? (unsigned long long)value : 0ULL - (unsigned long long)value), fbits, value < 0, prec, width, flags);
+}
+
+
+size_t tinyprintf_ftoa(char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+{
+#if defined(PRINTF_SUPPORT_FLOAT)
+    return _ftoa(_out_buffer, buffer, idx, maxlen, value, prec, width, flags);
+#else
+    (void)buffer; (void)maxlen; (void)value; (void)prec; (void)width; (void)flags;
+    return idx;
+#endif
+}
+
+
+size_t tinyprintf_str(char* buffer, size_t idx, size_t maxlen, const char* str, size_t len, unsigned int width, unsigned int flags)
+{
+    if (!(flags & FLAGS_LEFT) && (len < width)) {
+        idx = _out_pad(_out_buffer, buffer, idx, maxlen, width - len);
+    }
+    idx = _out_str(_out_buffer, buffer, idx, maxlen, str, len);
+    if ((flags & FLAGS_LEFT) && (len < width)) {
+        idx = _out_pad(_out_buffer, buffer, idx, maxlen, width - len);
+    }
+    return idx;
+}
+
+
 void _putchar(char character)
 {
 #ifdef PRINTF_USB
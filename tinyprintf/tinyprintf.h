@@ -55,6 +55,8 @@ void _putchar(char character);
  * You have to implement _putchar if you use printf()
  * To avoid conflicts with the regular printf() API it is overridden by macro defines
  * and internal underscore-appended functions like printf_() are used
+ * Besides the standard specifiers, %q<int bits>.<frac bits> (or %q<frac bits>) prints a
+ * signed fixed point value with integer arithmetic, e.g. printf("%.3q16.16", 0x18000) -> "1.500"
  * \param format A string that specifies the format of the output
  * \return The number of characters that are written into the array, not counting the terminating null character
  */
@@ -110,6 +112,37 @@ int vprintf_(const char* format, va_list va);
 int fctprintf(void (*out)(char character, void* arg), void* arg, const char* format, ...);
 
 
+/**
+ * printf with output function taking runs of characters
+ * Literal text, strings, padding and converted numbers are passed as one span
+ * \param out An output function which takes one character and an argument pointer
+ * \param out_blk An output function which takes a span of characters and an argument pointer
+ * \param arg An argument pointer for user data passed to output functions
+ * \param format A string that specifies the format of the output
+ * \return The number of characters that are sent to the output functions, not counting the terminating null character
+ */
+int fctprintf_blk(void (*out)(char character, void* arg), void (*out_blk)(const char* str, size_t len, void* arg), void* arg, const char* format, ...);
+
+
+/**
+ * Conversion kernels for callers that parse the format at compile time (cli.hpp)
+ * Each kernel converts one value with final flags, writes into buffer starting at idx
+ * (clipped to maxlen) and returns the index after the converted value
+ */
+#define PRINTF_FLAG_ZEROPAD     (1U <<  0U)
+#define PRINTF_FLAG_LEFT        (1U <<  1U)
+#define PRINTF_FLAG_PLUS        (1U <<  2U)
+#define PRINTF_FLAG_SPACE       (1U <<  3U)
+#define PRINTF_FLAG_HASH        (1U <<  4U)
+#define PRINTF_FLAG_UPPERCASE   (1U <<  5U)
+#define PRINTF_FLAG_PRECISION   (1U << 10U)
+
+size_t tinyprintf_ntoa(char* buffer, size_t idx, size_t maxlen, unsigned long long value, int negative, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags);
+size_t tinyprintf_qtoa(char* buffer, size_t idx, size_t maxlen, long long value, unsigned int fbits, unsigned int prec, unsigned int width, unsigned int flags);
+size_t tinyprintf_ftoa(char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags);
+size_t tinyprintf_str(char* buffer, size_t idx, size_t maxlen, const char* str, size_t len, unsigned int width, unsigned int flags);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,49 +1,243 @@
 #include "tinystring.h"
 
+/*
+ * Word-at-a-time (SWAR) kernels. Words are only read and written at aligned
+ * addresses (safe on Cortex-M0 and with unaligned traps enabled), a word that
+ * holds the terminator may be read past the end of the string but never crosses
+ * into the next word.
+ */
 
-void _strcpy(const char* src, uint16_t offsetSrc, char* dst, uint16_t offsetDst, uint16_t length)
+typedef uint32_t __attribute__((__may_alias__)) _word_t;
+
+#define _WORD_SIZE              (sizeof(_word_t))
+#define _WORD_MASK              (_WORD_SIZE - 1U)
+#define _ONES                   ((_word_t) 0x01010101UL)
+#define _HIGHS                  ((_word_t) 0x80808080UL)
+#define _HAS_ZERO(w)            ((((w) - _ONES) & ~(w)) & _HIGHS)
+#define _ALIGNED(p)             ((((uintptr_t) (p)) & _WORD_MASK) == 0U)
+#define _SAME_ALIGN(a, b)       (((((uintptr_t) (a)) ^ ((uintptr_t) (b))) & _WORD_MASK) == 0U)
+
+// aligned read of the terminator word is valid on hardware, host sanitizer reports it
+#if defined(__GNUC__)
+#define _WORD_READ              __attribute__((no_sanitize_address))
+#else
+#define _WORD_READ
+#endif
+
+
+void* _memcpy(void* dst, const void* src, size_t n)
 {
-    uint16_t i = 0;
-    for(; i < length; i++)
-        dst[i + offsetDst] = src[i + offsetSrc];
+    uint8_t* d = (uint8_t*) dst;
+    const uint8_t* s = (const uint8_t*) src;
+
+    if ((n >= 2U * _WORD_SIZE) && _SAME_ALIGN(d, s)) {
+        while (!_ALIGNED(d)) {
+            *d++ = *s++;
+            n--;
+        }
+        _word_t* dw = (_word_t*) d;
+        const _word_t* sw = (const _word_t*) s;
+        for (; n >= 4U * _WORD_SIZE; n -= 4U * _WORD_SIZE) {
+            dw[0] = sw[0];
+            dw[1] = sw[1];
+            dw[2] = sw[2];
+            dw[3] = sw[3];
+            dw += 4;
+            sw += 4;
+        }
+        for (; n >= _WORD_SIZE; n -= _WORD_SIZE) {
+            *dw++ = *sw++;
+        }
+        d = (uint8_t*) dw;
+        s = (const uint8_t*) sw;
+    }
+
+    // short copy, different alignment or tail
+    for (; n >= 4U; n -= 4U) {
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+        d[3] = s[3];
+        d += 4;
+        s += 4;
+    }
+    while (n--) {
+        *d++ = *s++;
+    }
+
+    return dst;
 }
 
 
-uint32_t _strlen(const char* strSrc)
+void* _memset(void* dst, int c, size_t n)
 {
-    int32_t co = 0;
-    while((strSrc != NULL) && (*strSrc != '\0')){
-        strSrc++;
-        co++;
+    uint8_t* d = (uint8_t*) dst;
+    const uint8_t b = (uint8_t) c;
+
+    if (n >= 2U * _WORD_SIZE) {
+        while (!_ALIGNED(d)) {
+            *d++ = b;
+            n--;
+        }
+        const _word_t w = _ONES * b;
+        _word_t* dw = (_word_t*) d;
+        for (; n >= _WORD_SIZE; n -= _WORD_SIZE) {
+            *dw++ = w;
+        }
+        d = (uint8_t*) dw;
+    }
+
+    while (n--) {
+        *d++ = b;
     }
 
-    return co;
+    return dst;
 }
 
 
-uint8_t _strcmp(const char* str1, const char* str2)
+void* _memmove(void* dst, const void* src, size_t n)
 {
-    uint16_t co = 0;
+    uint8_t* d = (uint8_t*) dst;
+    const uint8_t* s = (const uint8_t*) src;
 
-	if (_strlen(str1) != _strlen(str2))
-		return 0;
+    // forward copy is safe when destination is below source
+    if ((d <= s) || (d >= s + n))
+        return _memcpy(dst, src, n);
 
-    while(((str1 + co) != NULL) && (*(str1 + co) != '\0') &&
-          ((str2 + co) != NULL) && (*(str2 + co) != '\0')){
+    d += n;
+    s += n;
+    while (n--) {
+        *--d = *--s;
+    }
 
-        if (str1[co] != str2[co])
-            return 0;
+    return dst;
+}
+
+
+void _strcpy(const char* src, uint16_t offsetSrc, char* dst, uint16_t offsetDst, uint16_t length)
+{
+    _memcpy(dst + offsetDst, src + offsetSrc, length);
+}
 
-        co++;
+
+_WORD_READ
+uint32_t _strlen(const char* strSrc)
+{
+    const char* s = strSrc;
+
+    if (s == NULL)
+        return 0;
+
+    while (!_ALIGNED(s)) {
+        if (*s == '\0')
+            return (uint32_t) (s - strSrc);
+        s++;
     }
 
-    if   (
-            (((str1 + co) == NULL) && ((str2 + co) != NULL)) ||
-            (((str2 + co) == NULL) && ((str1 + co) != NULL)) ||
-            (((str1 + co) != NULL) && ((str2 + co) != NULL) && (*(str2 + co) != *(str1 + co)))
-         )
+    const _word_t* w = (const _word_t*) s;
+    while (!_HAS_ZERO(*w))
+        w++;
+
+    s = (const char*) w;
+    while (*s != '\0')
+        s++;
+
+    return (uint32_t) (s - strSrc);
+}
+
+
+/**
+ * @brief Compare up to n chars, stop at the terminator
+ * @return 1 - equal, 0 - not equal
+ */
+_WORD_READ
+static uint8_t _strequ(const char* str1, const char* str2, size_t n)
+{
+    // short strings and command names usually differ in the first char
+    if ((n == 0U) || (str1 == str2))
+        return 1;
+    if (*str1 != *str2)
         return 0;
 
+    if (_SAME_ALIGN(str1, str2)) {
+        while (!_ALIGNED(str1)) {
+            if (n-- == 0U)
+                return 1;
+            if (*str1 != *str2)
+                return 0;
+            if (*str1 == '\0')
+                return 1;
+            str1++;
+            str2++;
+        }
+
+        const _word_t* w1 = (const _word_t*) str1;
+        const _word_t* w2 = (const _word_t*) str2;
+        while ((n >= _WORD_SIZE) && !_HAS_ZERO(*w1)) {
+            if (*w1 != *w2)
+                break;
+            w1++;
+            w2++;
+            n -= _WORD_SIZE;
+        }
+        str1 = (const char*) w1;
+        str2 = (const char*) w2;
+    }
+
+    // last word, different alignment or bounded tail
+    for (; n != 0U; n--) {
+        if (*str1 != *str2)
+            return 0;
+        if (*str1 == '\0')
+            return 1;
+        str1++;
+        str2++;
+    }
 
     return 1;
 }
+
+
+uint8_t _strcmp(const char* str1, const char* str2)
+{
+    if ((str1 == NULL) || (str2 == NULL))
+        return str1 == str2;
+
+    return _strequ(str1, str2, (size_t) -1);
+}
+
+
+uint8_t _strncmp(const char* str1, const char* str2, size_t n)
+{
+    if ((str1 == NULL) || (str2 == NULL))
+        return str1 == str2;
+
+    return _strequ(str1, str2, n);
+}
+
+
+_WORD_READ
+char* _strcat(char* dst, const char* src)
+{
+    char* d = dst + _strlen(dst);
+
+    if (_SAME_ALIGN(d, src)) {
+        while (!_ALIGNED(d)) {
+            if ((*d++ = *src++) == '\0')
+                return dst;
+        }
+
+        _word_t* dw = (_word_t*) d;
+        const _word_t* sw = (const _word_t*) src;
+        while (!_HAS_ZERO(*sw))
+            *dw++ = *sw++;
+
+        d = (char*) dw;
+        src = (const char*) sw;
+    }
+
+    while ((*d++ = *src++) != '\0')
+        ;
+
+    return dst;
+}
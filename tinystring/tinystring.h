@@ -6,9 +6,14 @@
 #include <stdlib.h>
 
 
+void* _memcpy(void* dst, const void* src, size_t n);
+void* _memset(void* dst, int c, size_t n);
+void* _memmove(void* dst, const void* src, size_t n);
 void _strcpy(const char* src, uint16_t offsetSrc, char* dst, uint16_t offsetDst, uint16_t length);
-uint8_t _strcmp(const char* str1, const char* str2);
+uint8_t _strcmp(const char* str1, const char* str2);                // 1 - equal
+uint8_t _strncmp(const char* str1, const char* str2, size_t n);     // 1 - first n chars equal
 uint32_t _strlen(const char* strSrc);
+char* _strcat(char* dst, const char* src);
 
 
 
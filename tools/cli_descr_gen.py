@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+#
+# Compact & Simple Command Line Interface for microcontrollers
+#
+# Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Generator of compressed command descriptions (CLI_DESCR_MODE == 1).
+
+  cli_descr_gen.py -o cli_descr_data.h <sources...>
+
+Collects CLI_DESCR(ID, "...") descriptions of sources, builds shared
+dictionary of frequent words and writes header for lib/cli_descr.h and
+lib/cli_descr.c:
+
+  CLI_DESCR_DICT             - packed words: length byte + chars
+  CLI_DESCR_ID_<ID>          - compressed description of ID
+
+Sources refer to descriptions by ID only, so plain text never reaches the
+binary whatever the compiler and optimization level. One ID with different
+texts is an error.
+
+Compressed string: CLI_DESCR_MARK, then bytes 0x80 + i for word i of
+dictionary and ASCII chars as is. Strings with non-ASCII chars stay plain.
+"""
+
+import argparse
+import re
+import sys
+from collections import Counter
+
+MARK = 0x01
+MAX_WORDS = 128
+
+_DESCR_RE = re.compile(r'\bCLI_DESCR\s*\(\s*([A-Za-z_][A-Za-z0-9_]*)\s*,\s*((?:"(?:[^"\\\n]|\\.)*"\s*)+)\)')
+_LITERAL_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+_ESCAPES = {'n': '\n', 'r': '\r', 't': '\t', '\\': '\\', '"': '"', "'": "'", '?': '?', '0': '\0'}
+
+
+def _unescape(body):
+    out = []
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != '\\':
+            out.append(c)
+            i += 1
+            continue
+        n = body[i + 1]
+        if n == 'x':
+            m = re.match(r'[0-9a-fA-F]+', body[i + 2:])
+            out.append(chr(int(m.group(0), 16)))
+            i += 2 + len(m.group(0))
+        elif n in '01234567':
+            m = re.match(r'[0-7]{1,3}', body[i + 1:])
+            out.append(chr(int(m.group(0), 8)))
+            i += 1 + len(m.group(0))
+        else:
+            out.append(_ESCAPES.get(n, n))
+            i += 2
+    return ''.join(out)
+
+
+def _c_string(data):
+    """C literal of bytes, octal escapes are never continued by next char"""
+    out = ['"']
+    for b in data:
+        ch = chr(b)
+        if (0x20 <= b < 0x7F) and ch not in '"\\?':
+            out.append(ch)
+        else:
+            out.append('\\%03o' % b)
+    out.append('"')
+    return ''.join(out)
+
+
+def collect(paths):
+    """Descriptions by ID, in order of first use"""
+    descrs = {}
+    for path in paths:
+        with open(path, encoding='utf-8', errors='replace') as f:
+            text = f.read()
+        for m in _DESCR_RE.finditer(text):
+            s = ''.join(_unescape(body) for body in _LITERAL_RE.findall(m.group(2)))
+            if descrs.setdefault(m.group(1), s) != s:
+                raise ValueError('%s: CLI_DESCR(%s) has different text' % (path, m.group(1)))
+    return descrs
+
+
+def build_dict(descrs):
+    words = Counter()
+    for s in descrs.values():
+        if s.isascii():
+            words.update(w for w in s.split(' ') if w)
+
+    # saving of word: every use costs 1 byte instead of len, dictionary costs len + 1
+    saving = {w: n * (len(w) - 1) - (len(w) + 1) for w, n in words.items()}
+    best = sorted((w for w in saving if saving[w] > 0), key=lambda w: (-saving[w], w))
+    return best[:MAX_WORDS]
+
+
+def compress(s, index):
+    out = bytearray([MARK])
+    for i, w in enumerate(s.split(' ')):
+        if i:
+            out.append(ord(' '))
+        if w in index:
+            out.append(0x80 + index[w])
+        else:
+            out += w.encode('ascii')
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument('-o', '--output', required=True)
+    ap.add_argument('sources', nargs='+')
+    args = ap.parse_args()
+
+    try:
+        descrs = collect(args.sources)
+    except ValueError as e:
+        print('cli_descr_gen: %s' % e, file=sys.stderr)
+        return 1
+    words = build_dict(descrs)
+    index = {w: i for i, w in enumerate(words)}
+
+    plain = 0
+    packed = sum(len(w) + 1 for w in words)
+    lines = []
+    for id_, s in descrs.items():
+        data = s.encode('utf-8')
+        plain += len(data) + 1
+        if s.isascii() and all(0x02 <= ord(c) < 0x80 for c in s):
+            data = compress(s, index)
+        packed += len(data) + 1
+        lines.append('#define %-40s%s' % ('CLI_DESCR_ID_' + id_, _c_string(data)))
+
+    dict_lines = ['    %s' % _c_string(bytes([len(w)]) + w.encode('ascii')) for w in words]
+
+    with open(args.output, 'w') as f:
+        f.write('// Generated by tools/cli_descr_gen.py, do not edit\n')
+        f.write('// %u descriptions, %u words, %u bytes -> %u bytes\n\n' % (len(descrs), len(words), plain, packed))
+        f.write('#ifndef _CLI_DESCR_DATA_H_\n')
+        f.write('#define _CLI_DESCR_DATA_H_\n\n')
+        f.write('#define CLI_DESCR_DICT_COUNT                    (%u)\n' % len(words))
+        f.write('#define CLI_DESCR_DICT \\\n%s\n\n' % (' \\\n'.join(dict_lines) if dict_lines else '    ""'))
+        f.write('\n'.join(lines) + '\n\n')
+        f.write('#endif // _CLI_DESCR_DATA_H_\n')
+
+    print('cli_descr_gen: %u descriptions, %u bytes -> %u bytes' % (len(descrs), plain, packed), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
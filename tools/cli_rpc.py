@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+#
+# Compact & Simple Command Line Interface for microcontrollers
+#
+# Copyright (c) 2018 Vitaliy Nimych - vitaliy.nimych@gmail.com
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Host side of binary RPC mode (lib/cli_rpc.h).
+
+  cli_rpc.py --exec ./build/cli_host --list
+  cli_rpc.py --exec ./build/cli_host mr x:20000000
+  cli_rpc.py --dev /dev/pts/3 --bench 1000 mr x:20000000
+
+Arguments of command: u:<dec> (CLI_RPC_ARG_U32), i:<dec> (CLI_RPC_ARG_I32),
+x:<hex> (CLI_RPC_ARG_HEX), s:<text> or plain word (CLI_RPC_ARG_STR).
+Output of "mr" and "md" comes as typed values (hex word, memory bytes).
+--bench runs the same command N times in RPC mode and N times in text mode
+(waits for prompt after every line) and prints JSON result: measured rate of
+the link and rate of UART with --baud by bytes per request (echo, prompt and
+text replies of text mode, frames of RPC mode).
+"""
+
+import argparse
+import json
+import os
+import select
+import struct
+import subprocess
+import sys
+import time
+
+ENTER_SEQ = b"\x1b[9~"
+ID_LIST = 0xFFFF
+ID_EXIT = 0xFFFE
+VERSION = 2
+BAD_FRAME = 0x3F
+TYPED = 0x40
+TRUNCATED = 0x80
+PROMPT = b"\n\r>> "
+ARG_TYPES = {"u": (1, "<I"), "i": (2, "<i"), "x": (3, "<I"), "s": (4, None)}
+ARG_BYTES = 5
+STATUS = ["OK", "Err", "NotFound", "ArgErr", "ExecErr", "WorkInt", "Continue"]
+
+
+def _crc_table():
+    table = []
+    for i in range(256):
+        crc = i << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+        table.append(crc & 0xFFFF)
+    return table
+
+
+CRC_TABLE = _crc_table()
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc = ((crc << 8) & 0xFFFF) ^ CRC_TABLE[(crc >> 8) ^ b]
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code = 0
+    run = 1
+    for b in data:
+        if b != 0:
+            out.append(b)
+            run += 1
+        if b == 0 or run == 0xFF:
+            out[code] = run
+            code = len(out)
+            out.append(0)
+            run = 1
+    out[code] = run
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_args(words):
+    out = bytearray()
+    for w in words:
+        kind, sep, value = w.partition(":")
+        if not sep or kind not in ARG_TYPES:
+            kind, value = "s", w
+        code, fmt = ARG_TYPES[kind]
+        if fmt is None:
+            raw = value.encode()
+            out += bytes([code, len(raw)]) + raw
+        else:
+            out += bytes([code]) + struct.pack(fmt, int(value, 16 if kind == "x" else 10))
+    return bytes(out)
+
+
+def decode_values(payload):
+    """Typed values of response (status has TYPED flag)"""
+    values = []
+    i = 0
+    while i < len(payload):
+        code = payload[i]
+        i += 1
+        if code in (ARG_TYPES["s"][0], ARG_BYTES):
+            raw = payload[i + 1:i + 1 + payload[i]]
+            i += 1 + len(raw)
+            values.append(raw.decode(errors="replace") if code == ARG_TYPES["s"][0] else raw)
+        else:
+            value = struct.unpack("<i" if code == ARG_TYPES["i"][0] else "<I", payload[i:i + 4])[0]
+            i += 4
+            values.append("%08X" % value if code == ARG_TYPES["x"][0] else value)
+    return values
+
+
+def format_payload(status, payload):
+    if status != BAD_FRAME and status & TYPED:
+        return " ".join(v.hex(" ") if isinstance(v, bytes) else str(v) for v in decode_values(payload))
+    return payload.decode(errors="replace").strip("\r\n")
+
+
+class Link:
+    """Byte stream of device: pipes of process or character device"""
+
+    def __init__(self, rd, wr):
+        self.rd = rd
+        self.wr = wr
+        self.buf = bytearray()
+        self.tx = 0
+        self.rx = 0
+
+    def write(self, data):
+        self.tx += len(data)
+        os.write(self.wr, data)
+
+    def read_until(self, mark, timeout):
+        end = time.monotonic() + timeout
+        while True:
+            pos = self.buf.find(mark)
+            if pos >= 0:
+                data = bytes(self.buf[:pos + len(mark)])
+                del self.buf[:pos + len(mark)]
+                return data
+            left = end - time.monotonic()
+            if left <= 0 or not select.select([self.rd], [], [], left)[0]:
+                raise TimeoutError("no response")
+            chunk = os.read(self.rd, 4096)
+            if not chunk:
+                raise EOFError("link closed")
+            self.rx += len(chunk)
+            self.buf += chunk
+
+
+class RpcClient:
+    def __init__(self, link, timeout=1.0):
+        self.link = link
+        self.timeout = timeout
+        self.seq = 0
+        self.count = 0
+
+    def _frame(self):
+        """Next frame with valid CRC, other bytes (text output) are skipped"""
+        while True:
+            raw = cobs_decode(self.link.read_until(b"\0", self.timeout)[:-1])
+            if raw and len(raw) >= 4 and crc16(raw[:-2]) == struct.unpack("<H", raw[-2:])[0]:
+                return raw[:-2]
+
+    def enter(self):
+        self.link.write(ENTER_SEQ)
+        hello = self._frame()
+        if len(hello) != 5 or hello[0] != 0 or hello[1] != 0:
+            raise RuntimeError("bad hello frame")
+        version = hello[2]
+        if version != VERSION:
+            raise RuntimeError("protocol version %d, expected %d" % (version, VERSION))
+        self.count = hello[3] | (hello[4] << 8)
+        return version
+
+    def call(self, cmd_id, args=b""):
+        self.seq = (self.seq + 1) & 0xFF
+        req = struct.pack("<BH", self.seq, cmd_id) + args
+        self.link.write(cobs_encode(req + struct.pack("<H", crc16(req))) + b"\0")
+        resp = self._frame()
+        if resp[0] != self.seq:
+            raise RuntimeError("sequence %d, expected %d" % (resp[0], self.seq))
+        return resp[1], resp[2:]
+
+    def names(self):
+        _, payload = self.call(ID_LIST)
+        return [n.decode() for n in payload.split(b"\0")[:-1]]
+
+    def exit(self):
+        self.call(ID_EXIT)
+        self.link.read_until(PROMPT, self.timeout)
+
+
+def status_name(status):
+    if status == BAD_FRAME:
+        return "BadFrame"
+    code = status & ~(TRUNCATED | TYPED)
+    name = STATUS[code] if code < len(STATUS) else str(status)
+    return name + ("|Typed" if status & TYPED else "") + ("|Truncated" if status & TRUNCATED else "")
+
+
+def bench(client, cmd_id, args, line, n, baud):
+    link = client.link
+
+    bytes0 = link.tx + link.rx
+    t0 = time.monotonic()
+    for _ in range(n):
+        client.call(cmd_id, args)
+    rpc = time.monotonic() - t0
+    rpc_bytes = (link.tx + link.rx - bytes0) / n
+
+    client.exit()
+    bytes0 = link.tx + link.rx
+    t0 = time.monotonic()
+    for _ in range(n):
+        link.write(line.encode() + b"\r")
+        link.read_until(PROMPT, client.timeout)
+    text = time.monotonic() - t0
+    text_bytes = (link.tx + link.rx - bytes0) / n
+
+    # request and response are not overlapped: 10 bits per byte on UART
+    return {"command": line, "requests": n,
+            "rpc": {"per_sec": round(n / rpc), "bytes_per_request": round(rpc_bytes, 1),
+                    "per_sec_at_baud": round(baud / 10 / rpc_bytes)},
+            "text": {"per_sec": round(n / text), "bytes_per_request": round(text_bytes, 1),
+                     "per_sec_at_baud": round(baud / 10 / text_bytes)},
+            "baud": baud}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--exec", help="start device process (cli_host), talk over its stdin/stdout")
+    src.add_argument("--dev", help="character device of device (pty, serial port in raw mode)")
+    ap.add_argument("--list", action="store_true", help="print commands with IDs")
+    ap.add_argument("--bench", type=int, metavar="N", help="compare N requests of RPC and text mode")
+    ap.add_argument("--baud", type=int, default=115200, help="UART rate for requests per second of --bench")
+    ap.add_argument("command", nargs="*", help="command name and arguments")
+    opt = ap.parse_args()
+
+    if opt.exec:
+        proc = subprocess.Popen(opt.exec.split(), stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        link = Link(proc.stdout.fileno(), proc.stdin.fileno())
+    else:
+        fd = os.open(opt.dev, os.O_RDWR | os.O_NOCTTY)
+        link = Link(fd, fd)
+
+    client = RpcClient(link)
+    client.enter()
+    names = client.names()
+
+    if opt.list:
+        for i, name in enumerate(names):
+            print("%5d %s" % (i, name))
+
+    if opt.command:
+        if opt.command[0] not in names:
+            sys.exit("command not found: %s" % opt.command[0])
+        cmd_id = names.index(opt.command[0])
+        args = encode_args(opt.command[1:])
+        if opt.bench:
+            line = " ".join([opt.command[0]] + [w.partition(":")[2] or w for w in opt.command[1:]])
+            print(json.dumps(bench(client, cmd_id, args, line, opt.bench, opt.baud), indent=2))
+            return
+        status, payload = client.call(cmd_id, args)
+        sys.stdout.write(format_payload(status, payload) + "\n")
+        print("status: %s" % status_name(status))
+
+    client.exit()
+
+
+if __name__ == "__main__":
+    main()